@@ -0,0 +1,97 @@
+// Host-native stand-in for <FastLED.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef __INC_FASTSPI_LED2_H
+#define __INC_FASTSPI_LED2_H
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+enum EOrder { RGB = 0012, RBG = 0021, GRB = 0102, GBR = 0120, BRG = 0201, BGR = 0210 };
+#define DISABLE_DITHER 0x00
+#define BINARY_DITHER 0x01
+
+inline uint8_t scale8(uint8_t i, fract8 scale) { return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8); }
+inline uint8_t scale8_video(uint8_t i, fract8 scale) { return (uint8_t)((((uint16_t)i * (uint16_t)scale) >> 8) + ((i && scale) ? 1 : 0)); }
+
+struct CHSV
+{
+    uint8_t h, s, v;
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+    uint8_t r, g, b;
+    enum HTMLColorCode { Black = 0x000000, Red = 0xFF0000, Green = 0x008000, Blue = 0x0000FF, White = 0xFFFFFF };
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(HTMLColorCode code) : r((code >> 16) & 0xFF), g((code >> 8) & 0xFF), b(code & 0xFF) {}
+    CRGB(const CHSV &hsv) { hsv2rgb_rainbow(hsv, *this); }
+    uint8_t &operator[](uint8_t x) { return x == 0 ? r : (x == 1 ? g : b); }
+    CRGB &nscale8(uint8_t scale)
+    {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+    CRGB &nscale8_video(uint8_t scale)
+    {
+        r = scale8_video(r, scale);
+        g = scale8_video(g, scale);
+        b = scale8_video(b, scale);
+        return *this;
+    }
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER>
+class WS2812B
+{
+};
+
+class CLEDController
+{
+};
+
+class CFastLED
+{
+public:
+    template <template <uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController &addLeds(CRGB *data, int numLeds)
+    {
+        _leds = data;
+        _numLeds = numLeds;
+        return _controller;
+    }
+    void setBrightness(uint8_t scale) { _brightness = scale; }
+    uint8_t getBrightness() { return _brightness; }
+    void setDither(uint8_t ditherMode) { _dither = ditherMode; }
+    void setMaxPowerInVoltsAndMilliamps(uint8_t, uint32_t) {}
+    void show() { _shows++; }
+    void clearData()
+    {
+        if (_leds)
+        {
+            memset((void *)_leds, 0, sizeof(CRGB) * _numLeds);
+        }
+    }
+    unsigned long getShowCount() { return _shows; }
+    CRGB *leds() { return _leds; }
+    int size() { return _numLeds; }
+
+private:
+    CLEDController _controller;
+    CRGB *_leds = nullptr;
+    int _numLeds = 0;
+    uint8_t _brightness = 255;
+    uint8_t _dither = BINARY_DITHER;
+    unsigned long _shows = 0;
+};
+
+extern CFastLED FastLED;
+
+#endif
@@ -0,0 +1,22 @@
+// Host-native stand-in for <Random16.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef Random16_h
+#define Random16_h
+#include <Arduino.h>
+class Random16
+{
+public:
+    Random16(uint16_t seed = 0) { setSeed(seed); }
+    void setSeed(uint16_t seed) { _seed = seed; }
+    uint16_t getSeed() { return _seed; }
+    uint16_t get()
+    {
+        _seed = (_seed * 2053ul) + 13849;
+        return _seed;
+    }
+    uint16_t get(uint16_t max) { return ((uint32_t)max * get()) >> 16; }
+    uint16_t get(uint16_t min, uint16_t max) { return get(max - min) + min; }
+
+private:
+    uint16_t _seed;
+};
+#endif
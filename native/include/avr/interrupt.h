@@ -0,0 +1,10 @@
+// Host-native stand-in for <avr/interrupt.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef _AVR_INTERRUPT_H_
+#define _AVR_INTERRUPT_H_
+#include <avr/io.h>
+#define sei() (SREG |= (1 << SREG_I))
+#define cli() (SREG &= (uint8_t)~(1 << SREG_I))
+// on the host an ISR is a plain function the simulation harness can call
+#define ISR(vector, ...) extern "C" void vector(void); extern "C" void vector(void)
+#define ISR_NOBLOCK
+#endif
@@ -0,0 +1,55 @@
+// Host-native stand-in for <avr/io.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef _AVR_IO_H_
+#define _AVR_IO_H_
+#include <stdint.h>
+extern volatile uint8_t SREG, MCUCR, GIMSK, GIFR, PCMSK0, PCMSK1, PINA, PINB, PORTA, PORTB, DDRA, DDRB;
+extern volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+extern volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B;
+extern volatile uint8_t USICR, USISR, USIDR, USIBR, GPIOR0, GPIOR1, GPIOR2;
+#define GPIOR0 GPIOR0 // registers are macros on the AVR, so keep `#ifdef GPIOR0` style checks working
+#define SREG_I 7
+#define ISC00 0
+#define ISC01 1
+#define INT0 6
+#define INTF0 6
+#define PCIE0 4
+#define PCIE1 5
+#define PCIF0 4
+#define PCIF1 5
+#define PCINT8 0
+#define PCINT9 1
+#define PCINT10 2
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define OCIE0A 1
+#define TOIE0 0
+#define TOV0 0
+#define PORTA5 5
+#define OCF0A 1
+#define WGM12 3
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define OCIE1A 1
+#define OCF1A 1
+#define USIWM0 4
+#define USIWM1 5
+#define USICS0 2
+#define USICS1 3
+#define USICLK 1
+#define USITC 0
+#define USIOIF 6
+#define USISIF 7
+#define USICNT0 0
+#endif
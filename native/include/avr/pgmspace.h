@@ -0,0 +1,8 @@
+// Host-native stand-in for <avr/pgmspace.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_
+#include <stdint.h>
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#endif
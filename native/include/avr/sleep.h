@@ -0,0 +1,12 @@
+// Host-native stand-in for <avr/sleep.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef _AVR_SLEEP_H_
+#define _AVR_SLEEP_H_
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC 1
+#define SLEEP_MODE_PWR_DOWN 2
+void set_sleep_mode(uint8_t mode);
+void sleep_enable();
+void sleep_disable();
+void sleep_cpu();
+void sleep_bod_disable();
+#endif
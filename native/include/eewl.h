@@ -0,0 +1,32 @@
+// Host-native stand-in for <eewl.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef EEWL_H
+#define EEWL_H
+#include <Arduino.h>
+class EEWL
+{
+public:
+    template <typename T>
+    EEWL(T &, uint8_t, int) : _size(sizeof(T)) {}
+    void begin() {}
+    void fastFormat() { _stored = false; }
+    template <typename T>
+    bool get(T &data)
+    {
+        if (!_stored)
+            return false;
+        memcpy(&data, _buffer, sizeof(T));
+        return true;
+    }
+    template <typename T>
+    void put(T &data)
+    {
+        memcpy(_buffer, &data, sizeof(T) < sizeof(_buffer) ? sizeof(T) : sizeof(_buffer));
+        _stored = true;
+    }
+
+private:
+    size_t _size;
+    bool _stored = false;
+    uint8_t _buffer[32];
+};
+#endif
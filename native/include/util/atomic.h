@@ -0,0 +1,8 @@
+// Host-native stand-in for <util/atomic.h>, covering only what the firmware uses. See [env:native] in platformio.ini
+#ifndef _UTIL_ATOMIC_H_
+#define _UTIL_ATOMIC_H_
+#include <avr/interrupt.h>
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) for (uint8_t _atomicOnce = 1; _atomicOnce; _atomicOnce = 0)
+#endif
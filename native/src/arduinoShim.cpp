@@ -0,0 +1,87 @@
+// Host-native stand-ins for the Arduino core and avr-libc, see [env:native] in platformio.ini.
+//
+// Time is simulated: sleeping the CPU advances `millis` by one ms and fires the scheduler's
+// Timer1 compare ISR, so the firmware runs exactly as it would idling on the ATtiny, just faster
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <FastLED.h>
+#include <stdio.h>
+
+#include "leds.h" // for the optional stats in the summary
+
+#ifndef NATIVE_SIM_MILLIS
+#define NATIVE_SIM_MILLIS 20000 // simulated ms to run `loop()` for, before printing a summary and exiting
+#endif
+#ifndef NATIVE_SIM_TURN_MS
+#define NATIVE_SIM_TURN_MS 0 // if > 0, turn the encoder one detent every this many simulated ms, eg to exercise TRACK_INPUT_LATENCY
+#endif
+
+// ATtiny84 I/O registers, as plain memory (PINB idles high, as the inputs are pulled up)
+volatile uint8_t SREG, MCUCR, GIMSK, GIFR, PCMSK0, PCMSK1, PINA, PINB = 0xFF, PORTA, PORTB, DDRA, DDRB;
+volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A, OCR1B;
+volatile uint8_t USICR, USISR, USIDR, USIBR, GPIOR0, GPIOR1, GPIOR2;
+
+static unsigned long simMillis = 0;
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void digitalWrite(uint8_t, uint8_t) {}
+int analogRead(uint8_t) { return 512; }
+long map(long x, long inMin, long inMax, long outMin, long outMax) { return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin; }
+unsigned long millis() { return simMillis; }
+unsigned long micros() { return simMillis * 1000; }
+void delay(unsigned long ms) { simMillis += ms; }
+
+void set_sleep_mode(uint8_t) {}
+void sleep_enable() {}
+void sleep_disable() {}
+void sleep_bod_disable() {}
+
+extern "C" void TIM1_COMPA_vect(void) __attribute__((weak));
+extern "C" void PCINT1_vect(void) __attribute__((weak));
+void sleep_cpu()
+{
+    // "wake" on the next scheduler tick
+    simMillis++;
+    if (TIM1_COMPA_vect)
+    {
+        TIM1_COMPA_vect();
+    }
+#if NATIVE_SIM_TURN_MS > 0
+    if (simMillis % NATIVE_SIM_TURN_MS == 0 && PCINT1_vect)
+    {
+        // one detent clockwise, CLK/DAT on PB1/PB0, raising the pin change interrupt for each edge
+        static const uint8_t detent[4] = {0x01, 0x00, 0x02, 0x03};
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            PINB = (PINB & ~0x03) | detent[i];
+            PCINT1_vect();
+        }
+    }
+#endif
+}
+
+#if !defined(NATIVE_NO_MAIN) && !defined(PIO_UNIT_TESTING) // define to supply your own main, eg for benchmarks; unit tests bring their own
+int main()
+{
+    setup();
+    while (simMillis < NATIVE_SIM_MILLIS)
+    {
+        loop();
+    }
+    printf("ok shows=%lu millis=%lu\n", FastLED.getShowCount(), simMillis);
+#ifdef TRACK_INPUT_LATENCY
+    inputLatencyStats *latency = getInputLatency();
+    printf("input latency, per %dms:", INPUT_LATENCY_BUCKET_MS);
+    for (uint8_t i = 0; i < INPUT_LATENCY_BUCKETS; i++)
+    {
+        printf(" %u", latency->counts[i]);
+    }
+    printf(" (worst %ums)\n", latency->worstMillis);
+#endif
+    return 0;
+}
+#endif
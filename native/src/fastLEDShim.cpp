@@ -0,0 +1,37 @@
+// Host-native stand-ins for the parts of FastLED the firmware uses, see native/include/FastLED.h
+
+#include <FastLED.h>
+
+CFastLED FastLED;
+
+// six-region HSV to RGB conversion. Close to, but NOT bit-identical with, FastLED's rainbow hsv2rgb
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+    uint8_t region = hsv.h / 43;
+    uint8_t remainder = (hsv.h - (region * 43)) * 6;
+    uint8_t v = hsv.v;
+    uint8_t p = scale8(v, 255 - hsv.s);
+    uint8_t q = scale8(v, 255 - scale8(hsv.s, remainder));
+    uint8_t t = scale8(v, 255 - scale8(hsv.s, 255 - remainder));
+    switch (region)
+    {
+    case 0:
+        rgb = CRGB(v, t, p);
+        break;
+    case 1:
+        rgb = CRGB(q, v, p);
+        break;
+    case 2:
+        rgb = CRGB(p, v, t);
+        break;
+    case 3:
+        rgb = CRGB(p, q, v);
+        break;
+    case 4:
+        rgb = CRGB(t, p, v);
+        break;
+    default:
+        rgb = CRGB(v, p, q);
+        break;
+    }
+}
@@ -11,7 +11,9 @@
 #error Need to import the ByteMath script by Duck Pond Studio / Nick Yonge
 #endif
 
-#define DECAY_ENABLED false // if true, use decay to make value smaller with each iteration
+#ifndef DECAY_ENABLED
+#define DECAY_ENABLED false // if true, use decay to make value smaller with each iteration (can also be set as a build flag)
+#endif
 
 // just doing this as reference for how to validly check if a #define is EXPLICITLY true,
 // also excluding false, w/o throwing an error if undefined, and only needs an #ifdef check to work
@@ -21,7 +23,7 @@
 
 #define VALUE_MIN 64
 #define VALUE_MAX 255
-#define VCURVEPOW 3
+#define VCURVEPOW 3 // power of the curve applied to randomized values, 1 = linear, 2 = quadratic, 3 = cubic, etc
 #define VSPEED_MIN 2
 #define VSPEED_MAX 12
 #define VINTERVAL_MIN 4
@@ -29,7 +31,7 @@
 #ifdef DECAY_ENABLED
 #define DECAY_MIN 20
 #define DECAY_MAX 150
-#define DCURVEPOW 3
+#define DCURVEPOW 3 // power of the curve applied to randomized decay
 #define DMOD_MIN -15
 #define DMOD_MAX 25
 #define DDIVISOR 6
@@ -43,8 +45,77 @@
 #undef VCURVEPOW // check to undefine an invalid VCURVEPOW
 #endif
 #if defined(DCURVEPOW) && DCURVEPOW + 0 <= 0
-#undef DCURVEPOW // check to undefine an invalid VCURVEPOW
+#undef DCURVEPOW // check to undefine an invalid DCURVEPOW
+#endif
+
+// --- Curve lookup tables, generated at compile time into PROGMEM (see `ByteTable` in byteMath.h)
+
+// `ByteTable` generator mapping a random byte to `curvedLerpByte(byte, 0, 255, Power)`, scaled into `Min`-`Max` (inclusive).
+// Scaled by flooring into `Max - Min + 1` even buckets, so every result is equally likely before the curve
+template <byte Power, byte Min, byte Max>
+struct CurvedRandomGenerator
+{
+    static constexpr byte get(byte index)
+    {
+        return Min + (((uint16_t)curvedLerpByte(index, 0, UINT8_MAX, Power) * (Max - Min + 1)) >> 8);
+    }
+};
+
+// Returns a random byte from `Min` to `Max`, curved to `Power` via a PROGMEM table
+template <byte Power, byte Min, byte Max>
+struct curvedRandomByte
+{
+    static byte get(Random16 &rng)
+    {
+        // high byte of the LCG output, its low bits are far less random
+        return ByteTable<CurvedRandomGenerator<Power, Min, Max>>::get(rng.get() >> 8);
+    }
+};
+// power of 1 is linear, no table needed
+template <byte Min, byte Max>
+struct curvedRandomByte<1, Min, Max>
+{
+    static byte get(Random16 &rng)
+    {
+        return rng.get(Min, Max);
+    }
+};
+
+// Default ByteDrifter tuning, from the defines above. For a differently tuned drifter,
+// write a struct with the same members (or derive from this one and hide some) and pass
+// it as the template param, eg `ByteDrifter<MyDrifterConfig> drifter(rng);`
+//
+// Every limit is a compile-time constant, so it costs no RAM and folds into immediates
+struct ByteDrifterConfig
+{
+    static constexpr byte valueMin = VALUE_MIN;
+    static constexpr byte valueMax = VALUE_MAX;
+#ifdef VCURVEPOW
+    static constexpr byte vCurvePow = VCURVEPOW;
+#else
+    static constexpr byte vCurvePow = 1;
 #endif
+    static constexpr byte vSpeedMin = VSPEED_MIN;
+    static constexpr byte vSpeedMax = VSPEED_MAX;
+    static constexpr byte vIntervalMin = VINTERVAL_MIN;
+    static constexpr byte vIntervalMax = VINTERVAL_MAX;
+#ifdef DECAY_ENABLED
+    static constexpr byte decayMin = DECAY_MIN;
+    static constexpr byte decayMax = DECAY_MAX;
+#ifdef DCURVEPOW
+    static constexpr byte dCurvePow = DCURVEPOW;
+#else
+    static constexpr byte dCurvePow = 1;
+#endif
+    static constexpr int8_t dModMin = DMOD_MIN;
+    static constexpr int8_t dModMax = DMOD_MAX;
+    static constexpr byte dDivisor = DDIVISOR;
+    static constexpr byte dSpeedMin = DSPEED_MIN;
+    static constexpr byte dSpeedMax = DSPEED_MAX;
+    static constexpr byte dIntervalMin = DINTERVAL_MIN;
+    static constexpr byte dIntervalMax = DINTERVAL_MAX;
+#endif
+};
 
 //  192, 255, // value min/max defaults
 //  4, 20,    // vSpeed min/max defaults
@@ -67,75 +138,76 @@
 // NOTE: default values, specifically speed and interval,
 // are defined assuming a 30fps refresh rate, eg one call every ~33ms
 
+template <typename Config = ByteDrifterConfig>
 class ByteDrifter
 {
-public:
-    ByteDrifter(
-        byte valueMin, byte valueMax,
-#ifdef VCURVEPOW
-        byte vCurvePow,
-#endif
-        byte vSpeedMin, byte vSpeedMax,
-        byte vIntervalMin, byte vIntervalMax,
-#ifdef DECAY_ENABLED
-        byte decayMin, byte decayMax,
-#ifdef DCURVEPOW
-        byte dCurvePow,
-#endif
-        int8_t dModMin, int8_t dModMax,
-        byte dDivisor,
-        byte dSpeedMin, byte dSpeedMax,
-        byte dIntervalMin, byte dIntervalMax,
-#endif
-        Random16 &rng) :
-#ifdef DECAY_ENABLED
-                         _dDivisor(dDivisor),
-                         _dDivisorHalf(dDivisor / 2),
-#endif
-                         _valueMin(valueMin),
-                         _vSpeedMin(vSpeedMin),
-                         _vIntervalMin(vIntervalMin),
+    static_assert(Config::valueMin <= Config::valueMax, "ByteDrifter config valueMin must be <= valueMax");
+    static_assert(Config::vSpeedMin <= Config::vSpeedMax, "ByteDrifter config vSpeedMin must be <= vSpeedMax");
+    static_assert(Config::vIntervalMin <= Config::vIntervalMax, "ByteDrifter config vIntervalMin must be <= vIntervalMax");
 #ifdef DECAY_ENABLED
-                         _decayMin(decayMin),
-                         _dModMin(dModMin),
-                         _dSpeedMin(dSpeedMin),
-                         _dIntervalMin(dIntervalMin),
+    static_assert(Config::decayMin <= Config::decayMax, "ByteDrifter config decayMin must be <= decayMax");
+    static_assert(Config::dModMin <= Config::dModMax, "ByteDrifter config dModMin must be <= dModMax");
+    static_assert(Config::dDivisor > 0, "ByteDrifter config dDivisor must be > 0");
+    static_assert(Config::dSpeedMin <= Config::dSpeedMax, "ByteDrifter config dSpeedMin must be <= dSpeedMax");
+    static_assert(Config::dIntervalMin <= Config::dIntervalMax, "ByteDrifter config dIntervalMin must be <= dIntervalMax");
 #endif
-                         _valueMax(valueMax),
-                         _vSpeedMax(vSpeedMax),
-                         _vIntervalMax(vIntervalMax),
-#ifdef DECAY_ENABLED
-                         _decayMax(decayMax),
-                         _dModMax(dModMax),
-                         _dSpeedMax(dSpeedMax),
-                         _dIntervalMax(dIntervalMax),
-#endif
-                         _rng(rng)
+
+public:
+    ByteDrifter(Random16 &rng) : _rng(rng)
     {
-        // main constructor
         initialize();
     }
-    ByteDrifter(Random16 &rng)
-        : ByteDrifter(
-              VALUE_MIN, VALUE_MAX, // value min/max defaults
-#ifdef VCURVEPOW
-              VCURVEPOW, // value random curve power
+
+#ifdef DECAY_ENABLED
+    static constexpr byte stateSize = 12; // bytes written by `serialize`
+#else
+    static constexpr byte stateSize = 6; // bytes written by `serialize`
 #endif
-              VSPEED_MIN, VSPEED_MAX,       // vSpeed min/max defaults
-              VINTERVAL_MIN, VINTERVAL_MAX, // vInterval min/max defaults
+
+    // Writes the full drifter state (targets, params, actual/iterated values) into `state`, `stateSize` bytes long.
+    //
+    // Doesn't include the `Random16` state, save that separately via `getSeed`
+    void serialize(byte *state)
+    {
+        state[0] = _value;
+        state[1] = _vSpeed;
+        state[2] = _vInterval;
+        state[3] = _actualValue;
+        state[4] = _iteratedValue;
+        state[5] = _iteration;
 #ifdef DECAY_ENABLED
-              DECAY_MIN, DECAY_MAX, // decay min/max defaults
-#ifdef DCURVEPOW
-              DCURVEPOW, // decay random curve power
+        state[6] = _decay;
+        state[7] = (byte)_dMod;
+        state[8] = _dSpeed;
+        state[9] = _dInterval;
+        state[10] = _actualDecay;
+        state[11] = _iteratedDecay;
 #endif
-              DMOD_MIN, DMOD_MAX,           // dMod min/max defaults (signed, -128 ~ 127)
-              DDIVISOR,                     // dDivisor default (divide decay by this before value iteration)
-              DSPEED_MIN, DSPEED_MAX,       // dSpeed min/max defaults
-              DINTERVAL_MIN, DINTERVAL_MAX, // dInterval min/max defaults
+    }
+    // Restores drifter state previously written by `serialize` (from a drifter with the same config)
+    void deserialize(const byte *state)
+    {
+        _value = state[0];
+        _vSpeed = state[1];
+        _vInterval = state[2];
+        _actualValue = state[3];
+        _iteratedValue = state[4];
+        _iteration = state[5];
+#ifdef DECAY_ENABLED
+        _decay = state[6];
+        _dMod = (int8_t)state[7];
+        _dSpeed = state[8];
+        _dInterval = state[9];
+        _actualDecay = state[10];
+        _iteratedDecay = state[11];
 #endif
-              rng)
+    }
+
+    // Re-randomizes all targets and params and snaps values to them, as on construction.
+    // Call after reseeding the `Random16` for a sequence that depends only on the seed
+    void reset()
     {
-        // delegate, no code here, see main constructor above
+        initialize();
     }
 
     // Returns the current `value`, including iteration steps
@@ -152,6 +224,82 @@ public:
         return v;
     }
 
+    // Writes the next `count` values into `values`, autoiterating after each, in one call.
+    //
+    // Output is identical to calling `getValue()` `count` times, but far cheaper per value
+    void getValues(byte *values, uint16_t count)
+    {
+#ifdef DECAY_ENABLED
+        // rounded decay is tracked incrementally as quotient + remainder of (decay + half) / divisor,
+        // since decay only moves by dMod per iteration, dividing only when decay saturates
+        byte value = _iteratedValue;
+        byte decay = _iteratedDecay;
+        byte quotient;
+        int16_t remainder;
+        divideDecay(decay, quotient, remainder);
+        for (uint16_t i = 0; i < count; i++)
+        {
+            values[i] = value;
+            // apply iteration to value from decay (see `iterate`)
+            if (value > 0)
+            {
+                value = subtractByte(value, quotient);
+            }
+            // apply iteration to decay from dMod
+            if (_dMod > 0)
+            {
+                if (decay <= _dMod)
+                {
+                    decay = 0; // saturated
+                    divideDecay(decay, quotient, remainder);
+                }
+                else
+                {
+                    decay -= _dMod;
+                    remainder -= _dMod;
+                    while (remainder < 0)
+                    {
+                        remainder += Config::dDivisor;
+                        quotient--;
+                    }
+                }
+            }
+            else if (_dMod < 0)
+            {
+                byte add = -_dMod;
+                if (add >= UINT8_MAX - decay)
+                {
+                    decay = UINT8_MAX; // saturated
+                    divideDecay(decay, quotient, remainder);
+                }
+                else
+                {
+                    decay += add;
+                    remainder += add;
+                    while (remainder >= Config::dDivisor)
+                    {
+                        remainder -= Config::dDivisor;
+                        quotient++;
+                    }
+                }
+            }
+        }
+        _iteratedValue = value;
+        _iteratedDecay = decay;
+#else
+        // no decay, iterating never changes the value
+        memset(values, _iteratedValue, count);
+#endif
+        // increment iteration count
+        _iteration += count;
+    }
+
+    // Returns the actual (non-iterated) value, ie the first `getValue` after `resetIteration`
+    byte getActualValue()
+    {
+        return _actualValue;
+    }
+
     // iterate value for the next step
     void iterate()
     {
@@ -160,7 +308,7 @@ public:
         if (_iteratedValue > 0)
         {
             // determine rounded decay amount
-            byte roundedDecay = (_iteratedDecay + _dDivisorHalf) / _dDivisor; // add 1/2div to effectively "round to nearest unit"
+            byte roundedDecay = (_iteratedDecay + (Config::dDivisor / 2)) / Config::dDivisor; // add 1/2div to effectively "round to nearest unit"
             _iteratedValue = subtractByte(_iteratedValue, roundedDecay);
         }
         // apply iteration to decay from dMod
@@ -245,17 +393,9 @@ private:
     byte _value;     // target value
     byte _vSpeed;    // value speed
     byte _vInterval; // value interval
-#ifdef VCURVEPOW
-    byte _vCurvePow; // value curve power
-#endif
 #ifdef DECAY_ENABLED
     byte _decay; // target decay
-#ifdef DCURVEPOW
-    byte _dCurvePow;
-#endif
     int8_t _dMod;       // target dMod
-    byte _dDivisor;     // decay divisor
-    byte _dDivisorHalf; // half divisor
     byte _dSpeed;       // decay speed
     byte _dInterval;    // decay interval
 #endif
@@ -268,83 +408,33 @@ private:
     byte _iteratedDecay; // actual decay + iterations
 #endif
 
-    // minimum ranges for values
-    byte _valueMin;
-    byte _vSpeedMin;
-    byte _vIntervalMin;
-#ifdef DECAY_ENABLED
-    byte _decayMin;
-    int8_t _dModMin;
-    byte _dSpeedMin;
-    byte _dIntervalMin;
-#endif
-
-    // maximum ranges for values
-    byte _valueMax;
-    byte _vSpeedMax;
-    byte _vIntervalMax;
-#ifdef DECAY_ENABLED
-    byte _decayMax;
-    int8_t _dModMax;
-    byte _dSpeedMax;
-    byte _dIntervalMax;
-#endif
-
     Random16 &_rng; // reference to Random16
 
     byte _iteration;
 
     void randomizeValue()
     {
-#ifdef VCURVEPOW
-        uint32_t rand = (uint32_t)_rng.get();
-        uint32_t result = rand;
-        for (byte i = 1; i < _vCurvePow; i++) {
-            result *= rand;
-        }
-        byte shiftAmount = 16 + (8 * (_vCurvePow - 1));
-        _value = (byte)(result >> shiftAmount);
-
-        // if (squared > 100) {
-        //     _value = 128;
-        // } else {
-        // _value = 127;
-        // }
-        // float f = r / (float)UINT16_MAX;
-        // for (byte i = 0; i < _vCurvePow; i++)
-        // {
-        //     f *= f;
-        // }
-
-        // // return low + byte((float(high - low) * lerp) + 0.5);
-        // byte b = _valueMin + byte((float(_valueMax - _valueMin) * f) + 0.5);
-
-        // if (b > 127)
-        // {
-        //     _value = 128;
-        // }
-        // else
-        // {
-        //     _value = 127;
-        // }
-        // _value = curvedLerpByte(_rng.get(), _valueMin, _valueMax, _vCurvePow);
-#else
-        _value = _rng.get(_valueMin, _valueMax);
-#endif
-        _vSpeed = _rng.get(_vSpeedMin, _vSpeedMax);
-        _vInterval = _rng.get(_vIntervalMin, _vIntervalMax);
+        _value = curvedRandomByte<Config::vCurvePow <= 1 ? 1 : Config::vCurvePow, Config::valueMin, Config::valueMax>::get(_rng);
+        _vSpeed = _rng.get(Config::vSpeedMin, Config::vSpeedMax);
+        _vInterval = _rng.get(Config::vIntervalMin, Config::vIntervalMax);
     }
 #ifdef DECAY_ENABLED
     void randomizeDecay()
     {
-#ifdef DCURVEPOW
-        _decay = curvedLerpByte(_rng.get(), _decayMin, _decayMax, _dCurvePow);
-#else
-        _decay = _rng.get(_decayMin, _decayMax);
+        _decay = curvedRandomByte<Config::dCurvePow <= 1 ? 1 : Config::dCurvePow, Config::decayMin, Config::decayMax>::get(_rng);
+        _dMod = Config::dModMin + (int8_t)_rng.get(Config::dModMax - Config::dModMin);
+        _dSpeed = _rng.get(Config::dSpeedMin, Config::dSpeedMax);
+        _dInterval = _rng.get(Config::dIntervalMin, Config::dIntervalMax);
+    }
 #endif
-        _dMod = (int8_t)_rng.get((byte)_dModMin, (byte)_dModMax);
-        _dSpeed = _rng.get(_dSpeedMin, _dSpeedMax);
-        _dInterval = _rng.get(_dIntervalMin, _dIntervalMax);
+
+#ifdef DECAY_ENABLED
+    // divide (`decay` + half divisor) by the divisor, as `iterate` does to round decay
+    void divideDecay(byte decay, byte &quotient, int16_t &remainder)
+    {
+        uint16_t numerator = decay + (Config::dDivisor / 2);
+        quotient = numerator / Config::dDivisor;
+        remainder = numerator - (quotient * Config::dDivisor);
     }
 #endif
 
@@ -376,4 +466,122 @@ private:
     }
 };
 
+// Bank of `N` independent value-only drifters (eg one per LED), stored as a structure of arrays.
+//
+// Each channel drifts its own value toward its own random target, the same as `ByteDrifter`'s value,
+// but all channels share one `Random16` reference and are updated in one `tick()` pass.
+// Costs 4 bytes of SRAM per channel. Decay isn't used, there's no iteration down a bank
+template <uint16_t N, typename Config = ByteDrifterConfig>
+class ByteDrifterBank
+{
+    static_assert(N > 0, "ByteDrifterBank needs at least one channel");
+    static_assert(Config::valueMin <= Config::valueMax, "ByteDrifter config valueMin must be <= valueMax");
+    static_assert(Config::vSpeedMin <= Config::vSpeedMax, "ByteDrifter config vSpeedMin must be <= vSpeedMax");
+    static_assert(Config::vIntervalMin <= Config::vIntervalMax, "ByteDrifter config vIntervalMin must be <= vIntervalMax");
+
+public:
+    ByteDrifterBank(Random16 &rng) : _rng(rng)
+    {
+        reset();
+    }
+
+    static constexpr uint16_t stateSize = N * 4; // bytes written by `serialize`
+
+    // Writes every channel's state into `state`, `stateSize` bytes long.
+    //
+    // Doesn't include the `Random16` state, save that separately via `getSeed`
+    void serialize(byte *state)
+    {
+        memcpy(state, _value, N);
+        memcpy(state + N, _actual, N);
+        memcpy(state + (N * 2), _speed, N);
+        memcpy(state + (N * 3), _interval, N);
+    }
+    // Restores channel state previously written by `serialize` (from a bank with the same `N` and config)
+    void deserialize(const byte *state)
+    {
+        memcpy(_value, state, N);
+        memcpy(_actual, state + N, N);
+        memcpy(_speed, state + (N * 2), N);
+        memcpy(_interval, state + (N * 3), N);
+    }
+
+    // Re-randomizes every channel and snaps values to their targets, as on construction.
+    // Call after reseeding the `Random16` for a sequence that depends only on the seed
+    void reset()
+    {
+        for (uint16_t i = 0; i < N; i++)
+        {
+            randomizeChannel(i);
+            _actual[i] = _value[i];
+        }
+    }
+
+    // Returns the current value of channel `index`
+    byte getValue(uint16_t index)
+    {
+        return _actual[index];
+    }
+    // Returns all `N` current values, in channel order
+    const byte *getValues()
+    {
+        return _actual;
+    }
+
+    // Process one tick for every channel (move each value toward its target)
+    void tick()
+    {
+        for (uint16_t i = 0; i < N; i++)
+        {
+            // value interval
+            if (_interval[i] == 0)
+            {
+                // value interval is zero, reset channel params
+                randomizeChannel(i);
+            }
+            else
+            {
+                _interval[i]--;
+            }
+            // value drifts to target
+            byte actual = _actual[i];
+            byte target = _value[i];
+            if (actual < target)
+            {
+                _actual[i] = addByte(actual, _speed[i], target);
+            }
+            else if (actual > target)
+            {
+                _actual[i] = subtractByte(actual, _speed[i], target);
+            }
+        }
+    }
+
+private:
+    byte _value[N];    // target values
+    byte _actual[N];   // actual values
+    byte _speed[N];    // value speeds
+    byte _interval[N]; // value intervals
+
+    Random16 &_rng; // reference to Random16, shared by every channel
+
+    // Returns a random number from `0` to `range - 1`, taken from the top of `random`, leaving
+    // the unused fraction in `random` for the next call. Splits one RNG read into several values
+    static byte splitRandom(uint16_t &random, byte range)
+    {
+        uint32_t scaled = (uint32_t)random * range;
+        random = (uint16_t)scaled;
+        return scaled >> 16;
+    }
+
+    void randomizeChannel(uint16_t index)
+    {
+        _value[index] = curvedRandomByte<Config::vCurvePow <= 1 ? 1 : Config::vCurvePow, Config::valueMin, Config::valueMax>::get(_rng);
+        // speed and interval share a single RNG read
+        uint16_t random = _rng.get();
+        _speed[index] = Config::vSpeedMin + splitRandom(random, Config::vSpeedMax - Config::vSpeedMin);
+        _interval[index] = Config::vIntervalMin + splitRandom(random, Config::vIntervalMax - Config::vIntervalMin);
+    }
+};
+
 #endif // BYTEDRIFTER_H
@@ -1,70 +1,8 @@
-#include "bytemath.h"
+#include "byteMath.h"
 
-byte subtractByte(byte value, byte subtract, byte minValue = 0)
-{
-    if (value <= minValue)
-    {
-        return minValue; // value is below min, no sub needed, return min
-    }
-    if (subtract >= value)
-    {
-        return minValue; // sub is greater than value, no sub needed, return min
-    }
-    return max(minValue, value - subtract); // return the greater of minValue or value minus sub
-}
-byte subtractByte(byte value, int subtract, byte minValue = 0)
-{
-    return addByte(value, subtract * -1, minValue); // "add" negative int
-}
-byte addByte(byte value, byte add, byte maxValue = UINT8_MAX)
-{
-    if (value >= maxValue)
-    {
-        return maxValue; // value is at/above max, no ad needed, return max
-    }
-    if (add >= maxValue - value)
-    {
-        return maxValue; // add exceeds max minus value, no ad needed, return max
-    }
-    return value + add; // perform addition, will not exceed max value
-}
-byte addByte(byte value, int add, byte maxValue = UINT8_MAX)
-{
-    if (add == 0)
-    {
-        // zero value
-        return min(value, maxValue); // no addition, assume positive, return lower of value or maxValue
-    }
-    if (add < 0)
-    {
-        // negative value (note: maxValue means minValue, add means subtract)
-        if (value <= maxValue)
-        {
-            return maxValue; // value is below min, no sub needed, return min
-        }
-        add = abs(add); // convert to positive for proper subtraction
-        if (add >= value)
-        {
-            return maxValue; // sub is greater than value, no sub needed, return min
-        }
-        return max(maxValue, value - add); // return the greater of minValue or value minus sub
-    }
-    else
-    {
-        // positive value
-        if (value >= maxValue)
-        {
-            return maxValue; // value is at/above max, no ad needed, return max
-        }
-        if (add >= maxValue - value)
-        {
-            return maxValue; // add exceeds max minus value, no ad needed, return max
-        }
-        return value + add; // perform addition, will not exceed max value
-    }
-}
+#include "profile.h"
 
-byte int1024ToByte(int value, bool clamp = true)
+byte int1024ToByte(int value, bool clamp)
 {
     if (clamp)
     {
@@ -87,7 +25,7 @@ byte int1024ToByte(int value, bool clamp = true)
     return byte(value >> 2);
 }
 
-int byteToInt1024(byte value, bool clampLimits = true, bool solveFor256 = true)
+int byteToInt1024(byte value, bool clampLimits, bool solveFor256)
 {
     if (clampLimits)
     {
@@ -105,35 +43,35 @@ int byteToInt1024(byte value, bool clampLimits = true, bool solveFor256 = true)
     // bitshift to 10bit
     i = i << 2;
     // if solving for 256, multiply value by 256/255,
-    // or approx 1.0039, providing a more accurately
-    // scaled result, instead of essentially value * 4.
-    // eg, without clamping, inputting 255 would return
-    // 1020, making 1023 impossible to attain. this skews
-    // the math so that the output scales from 0-1023,
-    // instead of 0-(255*4).
-    // note however, that this performs float multiplication,
-    // which likely offset the above bitwise performance gains.
+    // providing a more accurately scaled result, instead
+    // of essentially value * 4. eg, without clamping,
+    // inputting 255 would return 1020, making 1023 impossible
+    // to attain. this skews the math so that the output
+    // scales from 0-1023, instead of 0-(255*4).
+    // i * 256/255 = i + (i / 255), and i >> 8 is exact
+    // enough for i <= 1020, so no multiply or divide needed
     if (solveFor256)
     {
-        i *= 1.0039; // approx 256/255
+        i += i >> 8;
     }
     return i;
 }
 
+#ifdef BYTEMATH_FLOAT_FUNCTIONS
 float byteToFloat01(byte input)
 {
     return (float)input / (float)UINT8_MAX;
 }
 float intToFloat01(int16_t input)
 {
-    return uint16ToFloat01((uint16_t)input);
+    return uint16ToFloat01(intToQ16(input));
 }
 float uint16ToFloat01(uint16_t input)
 {
     return (float)input / (float)UINT16_MAX;
 }
 
-byte lerpByte(float lerp, byte low = 0, byte high = UINT8_MAX)
+byte lerpByte(float lerp, byte low, byte high)
 {
     // basic validity checks
     if (low == high)
@@ -144,10 +82,6 @@ byte lerpByte(float lerp, byte low = 0, byte high = UINT8_MAX)
     {
         return high;
     }
-    if (high < low)
-    {
-        return low;
-    }
     if (lerp <= 0.998 || high < UINT8_MAX)
     {
         // safe to add 0.5 without potential overflow
@@ -156,25 +90,61 @@ byte lerpByte(float lerp, byte low = 0, byte high = UINT8_MAX)
     return UINT8_MAX; // no matter what, the result will be 255
 }
 
-byte curvedLerpByte(float lerp, byte low = 0, byte high = UINT8_MAX, byte power = 3)
+byte curvedLerpByte(float lerp, byte low, byte high, byte power)
 {
-    // raise the lerp curve to a given power
-    for (byte i = 0; i < power; i++)
+    // raise the lerp curve to a given power, lerp^power
+    float curved = lerp;
+    for (byte i = 1; i < power; i++)
     {
-        lerp *= lerp;
+        curved *= lerp;
     }
     // return the curved byte
-    return lerpByte(lerp, low, high);
+    return lerpByte(curved, low, high);
 }
-byte curvedLerpByte(byte lerp, byte low = 0, byte high = UINT8_MAX, byte power = 3)
-{
-    return curvedLerpByte(byteToFloat01(lerp), low, high, power);
-}
-byte curvedLerpByte(int16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = 3)
+#endif
+
+#if defined(ENABLE_PROFILING) && defined(PROFILE_BYTEMATH_KERNELS)
+void profileByteMathKernels()
 {
-    return curvedLerpByte(intToFloat01(lerp), low, high, power);
+    // inputs are read, and results written, through volatiles inside each window,
+    // so the compiler can't fold the kernels at build time or hoist them out of their markers
+    static volatile byte input;
+    static volatile int operand;
+    static volatile uint16_t lerp;
+    static volatile byte result;
+#ifdef BYTEMATH_FLOAT_FUNCTIONS
+    static volatile float lerpFloat;
+#endif
+    for (uint16_t i = 0; i <= UINT8_MAX; i++)
+    {
+        input = i;
+        operand = (int)i - 128;
+        lerp = byteToQ16(i);
+
+        PROFILE_BEGIN(PROFILE_KERNEL_ADD_BYTE);
+        result = addByte(input, operand, 200);
+        PROFILE_END(PROFILE_KERNEL_ADD_BYTE);
+
+        PROFILE_BEGIN(PROFILE_KERNEL_LERP_Q16);
+        result = lerpByteQ16(lerp, 10, 200);
+        PROFILE_END(PROFILE_KERNEL_LERP_Q16);
+
+        PROFILE_BEGIN(PROFILE_KERNEL_CURVE_Q16);
+        result = curvedLerpByteQ16(lerp, 10, 200);
+        PROFILE_END(PROFILE_KERNEL_CURVE_Q16);
+
+#ifdef BYTEMATH_FLOAT_FUNCTIONS
+        lerpFloat = byteToFloat01(i);
+
+        PROFILE_BEGIN(PROFILE_KERNEL_LERP_FLOAT);
+        result = lerpByte(lerpFloat, 10, 200);
+        PROFILE_END(PROFILE_KERNEL_LERP_FLOAT);
+
+        PROFILE_BEGIN(PROFILE_KERNEL_CURVE_FLOAT);
+        result = curvedLerpByte(lerpFloat, 10, 200);
+        PROFILE_END(PROFILE_KERNEL_CURVE_FLOAT);
+#endif
+    }
+    (void)result;
 }
-byte curvedLerpByte(uint16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = 3)
-{
-    return curvedLerpByte(uint16ToFloat01(lerp), low, high, power);
-}
\ No newline at end of file
+#endif
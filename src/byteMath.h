@@ -5,20 +5,47 @@
 
 #define DEFAULT_CURVE_LERP_POWER 3 // default power to use in `curvedLerpByte`
 
+// #define BYTEMATH_FLOAT_FUNCTIONS // also build the float versions of the normalize/lerp functions (pulls in soft-float, which is large and slow on AVR)
+
 // --- Basic add / subtract byte math with overflow prevention
+//
+// Saturating kernels, constexpr (so usable in table generation, see `ByteTable`) and inline,
+// so constant limits fold in and there's no call overhead per pixel. Each works in 16bit
+// and saturates with a single compare per bound
 
+// Returns int `value` clamped to `minValue`-`maxValue` (inclusive), default `0`-`255`
+constexpr byte clampByte(int value, byte minValue = 0, byte maxValue = UINT8_MAX)
+{
+    return value < minValue ? minValue : (value > maxValue ? maxValue : value);
+}
 // Subtracts byte `subtract` from given byte `value`, returning the result, WITHOUT UNDERFLOW.
 // Capped to `minValue`-255, default 'minValue = 0'
-byte subtractByte(byte value, byte subtract, byte minValue = 0);
-// Subtracts int `subtract` from given byte `value`, returning the result, WITHOUT OVER/UNDERFLOW.
-// Capped to `minValue`-255, default 'minValue = 0'
-byte subtractByte(byte value, int subtract, byte minValue = 0);
-// Adds byte `subtract` to given byte `value`, returning the result, WITHOUT OVERFLOW.
+constexpr byte subtractByte(byte value, byte subtract, byte minValue = 0)
+{
+    // -255 to 255, can't overflow
+    return value - subtract < minValue ? minValue : value - subtract;
+}
+// Adds byte `add` to given byte `value`, returning the result, WITHOUT OVERFLOW.
 // Capped to 0-`maxValue`, default `maxValue = 255`
-byte addByte(byte value, byte add, byte maxValue = UINT8_MAX);
-// Adds int `subtract` to given byte `value`, returning the result, WITHOUT OVER/UNDERFLOW.
+constexpr byte addByte(byte value, byte add, byte maxValue = UINT8_MAX)
+{
+    // 0 to 510, can't overflow
+    return value + add > maxValue ? maxValue : value + add;
+}
+// Adds int `add` (positive or negative) to given byte `value`, returning the result, WITHOUT OVER/UNDERFLOW.
 // Capped to 0-`maxValue`, default `maxValue = 255`
-byte addByte(byte value, int add, byte maxValue = UINT8_MAX);
+constexpr byte addByte(byte value, int add, byte maxValue = UINT8_MAX)
+{
+    // limit `add` first, so the sum can't overflow an int
+    return clampByte(value + constrain(add, -UINT8_MAX, UINT8_MAX), 0, maxValue);
+}
+// Subtracts int `subtract` (positive or negative) from given byte `value`, returning the result, WITHOUT OVER/UNDERFLOW.
+// Capped to `minValue`-255, default 'minValue = 0'
+constexpr byte subtractByte(byte value, int subtract, byte minValue = 0)
+{
+    // limit `subtract` first, so the difference can't overflow an int
+    return clampByte(value - constrain(subtract, -UINT8_MAX, UINT8_MAX), minValue, UINT8_MAX);
+}
 
 // --- Convert byte and int values for 8bit/10bit analog purposes
 
@@ -31,9 +58,142 @@ byte int1024ToByte(int value, bool clamp = true);
 
 // Converts byte `value` from a value of `0`-`255` to an int `0`-`1023`, using efficient bitshifting.
 // If `clampLimits` is `true` (default), `0` and `255` automatically return `0` and `1023`, respectively.
-// If `solveFor256` is `true` (default), final value is multiplied by `(256/255)`, giving a slightly more accurate output.
+// If `solveFor256` is `true` (default), final value is multiplied by `(256/255)` (in integer math), so it scales the full `0`-`1023`.
 int byteToInt1024(byte value, bool clampLimits = true, bool solveFor256 = true);
 
+// --- Convert byte and int values to 0.0-1.0 normalized Q0.16 fixed point
+//     (a uint16_t fraction, where `0` is `0.0` and `65535` is `1.0`, no floats needed)
+
+// Convert the given byte `input` to a Q0.16 fraction, where byte `0` is `0` (`0.0`) and byte `255` is `65535` (`1.0`)
+constexpr uint16_t byteToQ16(byte input)
+{
+    return input * 257; // 255 * 257 = 65535, exactly
+}
+// Convert the given int `input` to a Q0.16 fraction, where int `-32768` is `0` (`0.0`) and int `32767` is `65535` (`1.0`)
+constexpr uint16_t intToQ16(int16_t input)
+{
+    return (uint16_t)input ^ 0x8000; // offset by 32768
+}
+// Returns `value` / 65535, for `value` below 2^24, without a 32bit divide
+constexpr uint16_t divide65535(uint32_t value)
+{
+    return (value + (value >> 16) + 1) >> 16;
+}
+// Returns `product` / 65535, rounded to nearest, given `quotient` = `product` >> 16 (see `multiplyQ16`)
+constexpr uint16_t divide65535Rounded(uint32_t product, uint32_t quotient)
+{
+    // leftover past the approx quotient is under 2^18, so it can use `divide65535`
+    return quotient + divide65535(product - (quotient * 65535UL) + 32767);
+}
+// Returns Q0.16 fractions `a` times `b`, rounded to nearest
+constexpr uint16_t multiplyQ16(uint16_t a, uint16_t b)
+{
+    return divide65535Rounded((uint32_t)a * b, ((uint32_t)a * b) >> 16);
+}
+// Returns Q0.16 `curved` multiplied by `lerp`, `steps` times (tail recursive, so it compiles to a loop)
+constexpr uint16_t curveQ16Steps(uint16_t curved, uint16_t lerp, byte steps)
+{
+    return steps == 0 ? curved : curveQ16Steps(multiplyQ16(curved, lerp), lerp, steps - 1);
+}
+// Returns Q0.16 `lerp` raised to the power of `power`, `0` and `1` are linear
+constexpr uint16_t curveQ16(uint16_t lerp, byte power)
+{
+    return power <= 1 ? lerp : curveQ16Steps(lerp, lerp, power - 1);
+}
+
+// --- Lerp byte, and lerp along a curve, using 0.0-1.0 normalized Q0.16 fixed point
+//     (rounded to nearest, same as the float versions, and constexpr, see `ByteTable`).
+//     The Q0.16 input versions are suffixed, so they can't be confused with the float versions
+
+// Returns a byte, given Q0.16 `lerp` (`0` to `65535`, as `0.0` to `1.0`) on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
+constexpr byte lerpByteQ16(uint16_t lerp, byte low = 0, byte high = UINT8_MAX)
+{
+    // (high - low) * lerp / 65535, rounded to nearest (halves round up). If low > high, returns high
+    return low >= high ? high : low + divide65535(((uint32_t)(high - low) * lerp) + 32767);
+}
+// Returns a byte, given Q0.16 `lerp` (`0` to `65535`, as `0.0` to `1.0`),
+// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
+// where the input `lerp` is raised to the power of `power` (default `3`), eg 2 = quadratic, 3 = cubic curve (see https://easings.net/#easeInCubic).
+// `power` is a true exponent, `0` and `1` are linear
+constexpr byte curvedLerpByteQ16(uint16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER)
+{
+    return lerpByteQ16(curveQ16(lerp, power), low, high);
+}
+// Returns a byte, given byte `lerp` (`0` to `255`, as `0.0` to `1.0`),
+// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
+// where the input `lerp` is raised to the power of `power` (default `3`), eg 2 = quadratic, 3 = cubic curve (see https://easings.net/#easeInCubic).
+// `power` is a true exponent, `0` and `1` are linear
+constexpr byte curvedLerpByte(byte lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER)
+{
+    return curvedLerpByteQ16(byteToQ16(lerp), low, high, power);
+}
+// Returns a byte, given int `lerp` (`-32768` to `32767`, as `0.0` to `1.0`),
+// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
+// where the input `lerp` is raised to the power of `power` (default `3`), eg 2 = quadratic, 3 = cubic curve (see https://easings.net/#easeInCubic).
+// `power` is a true exponent, `0` and `1` are linear
+constexpr byte curvedLerpByte(int16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER)
+{
+    return curvedLerpByteQ16(intToQ16(lerp), low, high, power);
+}
+// Returns a byte, given unsigned int `lerp` (`0` to `65535`, as `0.0` to `1.0`),
+// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
+// where the input `lerp` is raised to the power of `power` (default `3`). Same as `curvedLerpByteQ16`, kept for existing callers
+constexpr byte curvedLerpByte(uint16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER)
+{
+    return curvedLerpByteQ16(lerp, low, high, power);
+}
+
+// --- Compile-time PROGMEM lookup tables
+//
+// Bakes any constexpr byte function of a byte index into flash at build time, eg:
+//     typedef ByteTable<CurvedLerpGenerator<2, 10, 200>> myCurve; // 256 bytes of flash, no RAM
+//     byte b = myCurve::get(i);                                   // one pgm_read_byte at runtime
+// Tables are only emitted for the generators actually used
+
+// compile-time sequence of bytes `0`-`N-1`, for generating tables
+template <byte... I>
+struct byteSequence
+{
+};
+template <uint16_t N, byte... I>
+struct makeByteSequence : makeByteSequence<N - 1, N - 1, I...>
+{
+};
+template <byte... I>
+struct makeByteSequence<0, I...>
+{
+    typedef byteSequence<I...> type;
+};
+
+// PROGMEM table of `Length` (max 256) bytes, where `values[i]` = `Generator::get(i)`.
+// `Generator` is any type with a `static constexpr byte get(byte index)`
+template <typename Generator, uint16_t Length = 256, typename Sequence = typename makeByteSequence<Length>::type>
+struct ByteTable;
+template <typename Generator, uint16_t Length, byte... I>
+struct ByteTable<Generator, Length, byteSequence<I...>>
+{
+    static_assert(Length > 0 && Length <= 256, "ByteTable Length must be 1-256");
+    static const byte values[sizeof...(I)];
+    // Returns table entry `index` (read from PROGMEM)
+    static byte get(byte index)
+    {
+        return pgm_read_byte(&values[index]);
+    }
+};
+template <typename Generator, uint16_t Length, byte... I>
+const byte ByteTable<Generator, Length, byteSequence<I...>>::values[sizeof...(I)] PROGMEM = {Generator::get(I)...};
+
+// `ByteTable` generator for `curvedLerpByte(index, Low, High, Power)`
+template <byte Power, byte Low = 0, byte High = UINT8_MAX>
+struct CurvedLerpGenerator
+{
+    static constexpr byte get(byte index)
+    {
+        return curvedLerpByte(index, Low, High, Power);
+    }
+};
+
+#ifdef BYTEMATH_FLOAT_FUNCTIONS
 // --- Convert byte and int values to 0.0-1.0 normalized floats
 //     (I know, technically it's some non-byte math, oops ^_^ )
 
@@ -52,19 +212,21 @@ float uint16ToFloat01(uint16_t input);
 // Returns a byte, given float `lerp` (`0.0` to `1.0`) on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
 byte lerpByte(float lerp, byte low = 0, byte high = UINT8_MAX);
 // Returns a byte, given float `lerp` (`0.0` to `1.0`) on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
-// where the input `lerp` is raised to the power of `power` (default `3), eg 3 = cubic curve (see https://easings.net/#easeInCubic)
+// where the input `lerp` is raised to the power of `power` (default `3`), eg 3 = cubic curve (see https://easings.net/#easeInCubic)
 byte curvedLerpByte(float lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER);
-// Returns a byte, given byte `lerp` (`0` to `255`, which is normalized to a float from `0.0` to `1.0`),
-// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
-// where the input `lerp` is raised to the power of `power` (default `3), eg 3 = cubic curve (see https://easings.net/#easeInCubic)
-byte curvedLerpByte(byte lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER);
-// Returns a byte, given int `lerp` (`-32768` to `32767`, which is normalized to a float from `0.0` to `1.0`),
-// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
-// where the input `lerp` is raised to the power of `power` (default `3), eg 3 = cubic curve (see https://easings.net/#easeInCubic)
-byte curvedLerpByte(int16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER);
-// Returns a byte, given unsigned int `lerp` (`0` to `65535`, which is normalized to a float from `0.0` to `1.0`),
-// on a range from `low` (`0.0`, default `0`) to `high` (`1.0`, default `255`)
-// where the input `lerp` is raised to the power of `power` (default `3), eg 3 = cubic curve (see https://easings.net/#easeInCubic)
-byte curvedLerpByte(uint16_t lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER);
+// forwarding overloads, so double literals (eg `lerpByte(0.5)`) and ints (eg `lerpByte(1)`) aren't ambiguous
+inline byte lerpByte(double lerp, byte low = 0, byte high = UINT8_MAX)
+{
+    return lerpByte((float)lerp, low, high);
+}
+inline byte lerpByte(int lerp, byte low = 0, byte high = UINT8_MAX)
+{
+    return lerpByte((float)lerp, low, high);
+}
+inline byte curvedLerpByte(double lerp, byte low = 0, byte high = UINT8_MAX, byte power = DEFAULT_CURVE_LERP_POWER)
+{
+    return curvedLerpByte((float)lerp, low, high, power);
+}
+#endif
 
 #endif // BYTEMATH_H
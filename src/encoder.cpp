@@ -0,0 +1,128 @@
+#include "encoder.h"
+
+#include <util/atomic.h>
+
+#include "byteMath.h"
+#include "scheduler.h"
+
+// quadrature step for each transition, indexed by (previous state << 2) | current state,
+// where state is (CLK << 1) | DAT. Invalid transitions (both pins changed, ie a missed step) count as 0.
+// Signed so that a positive delta matches the direction `loopInput` has always used
+static const int8_t encoderTransitions[16] PROGMEM = {
+    0, -1, 1, 0,  // from 00
+    1, 0, 0, -1,  // from 01
+    -1, 0, 0, 1,  // from 10
+    0, 1, -1, 0}; // from 11
+
+static byte encoderState = ENCODER_LATCH_STATE;   // pin state as of the last tick
+static int8_t encoderSteps = 0;                   // quadrature steps since the last detent
+static volatile int8_t encoderDelta = 0;          // detents held since the last `readEncoderDelta`, saturating
+static uint16_t encoderDetentTick = 0;            // scheduler tick of the most recent detent fed to `readEncoderInterval`
+
+#ifdef ENC_ROTATION_ACCELERATION
+// `ByteTable` generator for the acceleration gain of table entry `index`, covering the interval
+// (index << ENC_ACCEL_BUCKET_SHIFT) ms between detents. Linear from GAIN_MAX at FAST_MS down to GAIN_MIN at SLOW_MS
+struct EncoderGainGenerator
+{
+    static constexpr byte gain(uint16_t ms)
+    {
+        return ms <= ENC_ACCEL_FAST_MS   ? ENC_ACCEL_GAIN_MAX
+               : ms >= ENC_ACCEL_SLOW_MS ? ENC_ACCEL_GAIN_MIN
+                                         : ENC_ACCEL_GAIN_MAX - ((ENC_ACCEL_GAIN_MAX - ENC_ACCEL_GAIN_MIN) * (ms - ENC_ACCEL_FAST_MS) + (ENC_ACCEL_SLOW_MS - ENC_ACCEL_FAST_MS) / 2) / (ENC_ACCEL_SLOW_MS - ENC_ACCEL_FAST_MS);
+    }
+    static constexpr byte get(byte index)
+    {
+        return gain((uint16_t)index << ENC_ACCEL_BUCKET_SHIFT);
+    }
+};
+// gain per detent, indexed by interval >> ENC_ACCEL_BUCKET_SHIFT
+typedef ByteTable<EncoderGainGenerator, (256 >> ENC_ACCEL_BUCKET_SHIFT)> EncoderGainTable;
+#endif
+
+// Returns the current encoder pin state, (CLK << 1) | DAT, from a single PINB read
+static inline byte readEncoderState()
+{
+    byte pins = PINB;
+#if PORTB_BIT_ENC_DAT == 0 && PORTB_BIT_ENC_CLK == 1
+    return pins & 0x03; // already in order
+#else
+    return ((pins >> PORTB_BIT_ENC_DAT) & 0x01) | (((pins >> PORTB_BIT_ENC_CLK) & 0x01) << 1);
+#endif
+}
+
+void setupEncoder()
+{
+    pinMode(PIN_ENC_CLK, INPUT_PULLUP);
+    pinMode(PIN_ENC_DAT, INPUT_PULLUP);
+    encoderState = readEncoderState();
+    encoderSteps = 0;
+    encoderDelta = 0;
+    encoderDetentTick = getSchedulerTicks() - (UINT8_MAX + 1); // no previous detent, first one counts as slow
+}
+
+int8_t tickEncoder()
+{
+    byte state = readEncoderState();
+    encoderSteps += (int8_t)pgm_read_byte(&encoderTransitions[(encoderState << 2) | state]);
+    encoderState = state;
+    if (state != ENCODER_LATCH_STATE)
+    {
+        return 0; // between detents
+    }
+    // back at rest, count a detent if most of its steps were seen (tolerates a missed step or bounce on fast spins)
+    int8_t steps = encoderSteps;
+    encoderSteps = 0;
+    if (steps >= ENCODER_STEPS_PER_DETENT / 2)
+    {
+        return 1;
+    }
+    if (steps <= -(ENCODER_STEPS_PER_DETENT / 2))
+    {
+        return -1;
+    }
+    return 0; // bounced back to the same detent
+}
+
+void holdEncoderDetent(int8_t detents)
+{
+    int delta = encoderDelta + detents;
+    encoderDelta = delta > INT8_MAX ? INT8_MAX : delta < INT8_MIN ? INT8_MIN : delta;
+}
+
+int8_t readEncoderDelta()
+{
+    int8_t delta;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        PROFILE_BEGIN(PROFILE_ENCODER_READ);
+        delta = encoderDelta;
+        encoderDelta = 0;
+        PROFILE_END(PROFILE_ENCODER_READ);
+    }
+    return delta;
+}
+
+byte readEncoderInterval(uint16_t time)
+{
+    uint16_t elapsed = time - encoderDetentTick;
+    encoderDetentTick = time;
+    return elapsed > UINT8_MAX ? UINT8_MAX : elapsed;
+}
+
+void ageEncoder()
+{
+    uint16_t now = getSchedulerTicks();
+    if ((uint16_t)(now - encoderDetentTick) > UINT8_MAX)
+    {
+        // already saturated, keep it there rather than letting it wrap back around
+        encoderDetentTick = now - (UINT8_MAX + 1);
+    }
+}
+
+#ifdef ENC_ROTATION_ACCELERATION
+int8_t accelerateEncoderDelta(int8_t detents, byte interval)
+{
+    int delta = detents * EncoderGainTable::get(interval >> ENC_ACCEL_BUCKET_SHIFT);
+    return delta > INT8_MAX ? INT8_MAX : delta < -INT8_MAX ? -INT8_MAX : delta;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <Arduino.h>
+
+#include "pindef.h"
+
+#define ENCODER_STEPS_PER_DETENT 4 // quadrature steps per encoder detent (one full CLK/DAT cycle per click)
+#define ENCODER_LATCH_STATE 0x03   // pin state at rest on a detent (both CLK and DAT high), where steps are counted as detents
+
+#define ENC_ROTATION_ACCELERATION // should encoder speed be accelerated? scales each detent by a gain looked up from the time between detents
+#ifdef ENC_ROTATION_ACCELERATION
+#define ENC_ACCEL_GAIN_MIN 6       // delta per detent when turning slowly (at or slower than ENC_ACCEL_SLOW_MS per detent), same as the fixed ENC_NONACCEL_MULTIPLIER step (see input.h)
+#define ENC_ACCEL_GAIN_MAX 20      // delta per detent when spinning fast (at or faster than ENC_ACCEL_FAST_MS per detent)
+#define ENC_ACCEL_SLOW_MS 120      // ms between detents at or above which there is no acceleration (ENC_ACCEL_GAIN_MIN)
+#define ENC_ACCEL_FAST_MS 8        // ms between detents at or below which acceleration is maxed (ENC_ACCEL_GAIN_MAX)
+#define ENC_ACCEL_BUCKET_SHIFT 3   // gain table resolution, each entry covers (1 << ENC_ACCEL_BUCKET_SHIFT) ms, eg 3 = 8ms, 32 entries
+#endif
+
+// set up the encoder pins and initial state, call before enabling encoder pin interrupts
+void setupEncoder();
+// Decode the current encoder pin state (one PINB read), returning the direction of the detent completed,
+// 1 or -1 (as per `loopInput`), or 0 if none was.
+//
+// Call from the encoder pin change interrupt. If calling anywhere else, wrap in an `ATOMIC_BLOCK`
+int8_t tickEncoder();
+// Hold detents decoded by `tickEncoder` that couldn't be queued as input events (see inputQueue.h), for `readEncoderDelta`.
+//
+// Call from the encoder pin change interrupt. If calling anywhere else, wrap in an `ATOMIC_BLOCK`
+void holdEncoderDetent(int8_t detents);
+// Returns the detents held since the last call (signed, saturating), and resets it to zero
+int8_t readEncoderDelta();
+// Returns the ms between the previous detent and one turned at scheduler tick `time`, saturating at `UINT8_MAX`,
+// and records `time` as the most recent detent. Feed detents oldest first. Only call from the main loop
+byte readEncoderInterval(uint16_t time);
+// Ages the most recent detent's timestamp so it's never more than just over `UINT8_MAX` ms old, so that after
+// a long idle, the 16bit tick count can't wrap around into a short (fast, max gain) interval for the next detent.
+//
+// Call regularly from the main loop, at least every ~65 seconds while awake (eg every `loopInput`)
+void ageEncoder();
+
+#ifdef ENC_ROTATION_ACCELERATION
+// Returns `detents` scaled by the gain for the given ms `interval` between detents (see `ENC_ACCEL_GAIN_MIN`),
+// saturating at +/-127 so the result can't wrap a full turn of the colour wheel
+int8_t accelerateEncoderDelta(int8_t detents, byte interval);
+#endif
+
+// error check for encoder pins, both must be readable in a single PINB read
+#if PORTB_BIT_ENC_DAT > 7 || PORTB_BIT_ENC_CLK > 7 || PORTB_BIT_ENC_DAT == PORTB_BIT_ENC_CLK
+#error "Encoder CLK and DAT must be two different Port B bits, see pindef.h"
+#endif
+#if ENCODER_STEPS_PER_DETENT < 2
+#error "ENCODER_STEPS_PER_DETENT must be at least 2"
+#endif
+#ifdef ENC_ROTATION_ACCELERATION
+#if ENC_ACCEL_FAST_MS >= ENC_ACCEL_SLOW_MS || ENC_ACCEL_SLOW_MS > 255
+#error "ENC_ACCEL_FAST_MS must be less than ENC_ACCEL_SLOW_MS, and ENC_ACCEL_SLOW_MS at most 255 (see readEncoderInterval)"
+#endif
+#if ENC_ACCEL_GAIN_MIN < 1 || ENC_ACCEL_GAIN_MAX < ENC_ACCEL_GAIN_MIN || ENC_ACCEL_GAIN_MAX > 127
+#error "ENC_ACCEL_GAIN_MIN must be at least 1, and ENC_ACCEL_GAIN_MAX between ENC_ACCEL_GAIN_MIN and 127"
+#endif
+#if ENC_ACCEL_BUCKET_SHIFT < 0 || ENC_ACCEL_BUCKET_SHIFT > 7
+#error "ENC_ACCEL_BUCKET_SHIFT must be 0-7"
+#endif
+#endif
+
+#endif // ENCODER_H
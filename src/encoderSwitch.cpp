@@ -0,0 +1,49 @@
+#include "encoderSwitch.h"
+
+#include <util/atomic.h>
+
+#include "inputQueue.h"
+#include "profile.h"
+
+// mask of the switch history bits that must all agree before the state changes
+#define ENC_SWITCH_DEBOUNCE_MASK ((byte)((1 << ENC_SWITCH_DEBOUNCE_TICKS) - 1))
+
+static byte encSwitchHistory = 0;     // most recent raw samples, one per tick, newest in bit 0 (1 = pressed)
+static bool encSwitchPressed = false; // debounced switch state, as last reported by a press/release event
+
+void setupEncoderSwitch()
+{
+    pinMode(PIN_ENC_SWITCH, INPUT_PULLUP);
+    resetEncoderSwitch();
+}
+
+void tickEncoderSwitch()
+{
+    // NC switch, low = pressed
+    encSwitchHistory = (encSwitchHistory << 1) | !(PINB & (1 << PORTB_BIT_ENC_SWITCH));
+    byte samples = encSwitchHistory & ENC_SWITCH_DEBOUNCE_MASK;
+    if (encSwitchPressed)
+    {
+        if (samples == 0)
+        {
+            encSwitchPressed = false;
+            pushInputEvent(INPUT_EVENT_SWITCH_RELEASE);
+        }
+    }
+    else if (samples == ENC_SWITCH_DEBOUNCE_MASK)
+    {
+        encSwitchPressed = true;
+        pushInputEvent(INPUT_EVENT_SWITCH_PRESS);
+    }
+}
+
+void resetEncoderSwitch()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        PROFILE_BEGIN(PROFILE_SWITCH_RESET);
+        encSwitchHistory = 0;
+        encSwitchPressed = false;
+        PROFILE_END(PROFILE_SWITCH_RESET);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef ENCODERSWITCH_H
+#define ENCODERSWITCH_H
+
+#include <Arduino.h>
+
+#include "pindef.h"
+
+#define ENC_SWITCH_DEBOUNCE_TICKS 8 // consecutive scheduler ticks (ms) the switch must read steady to change state, 1-8. Also the press/release latency
+
+// set up the encoder switch pin and debounce state (released)
+void setupEncoderSwitch();
+// Sample the encoder switch pin into the debouncer, pushing an `INPUT_EVENT_SWITCH_PRESS` or `_RELEASE`
+// event (timestamped, see inputQueue.h) when the switch has held a new state for `ENC_SWITCH_DEBOUNCE_TICKS`.
+//
+// IMPORTANT: only call from the scheduler tick interrupt (it pushes input events)
+void tickEncoderSwitch();
+// Reset the debouncer to released, eg after waking. A switch still held down is reported as a new press once it's steady
+void resetEncoderSwitch();
+
+// error check for debounce length (history is a single byte)
+#if ENC_SWITCH_DEBOUNCE_TICKS < 1 || ENC_SWITCH_DEBOUNCE_TICKS > 8
+#error "ENC_SWITCH_DEBOUNCE_TICKS must be 1-8"
+#endif
+
+#endif // ENCODERSWITCH_H
@@ -0,0 +1,83 @@
+#include "gesture.h"
+
+// recognizer states
+#define GESTURE_STATE_IDLE 0   // switch released, nothing pending
+#define GESTURE_STATE_DOWN 1   // switch pressed, might become a click, long press or press-turn
+#define GESTURE_STATE_UP 2     // switch clicked once, waiting to see if it's a double-click
+#define GESTURE_STATE_DOWN2 3  // switch pressed again after a click, might become a double-click
+#define GESTURE_STATE_ADJUST 4 // switch held down and turned, until released
+#define GESTURE_STATE_HELD 5   // long press reported, until released or turned
+#define GESTURE_STATES 6
+
+#define GESTURE_INPUTS 4
+
+// transition table entries: bit 7 = re-feed the input to the next state, bits 6-4 = next state, bits 3-0 = gesture to report
+#define GESTURE_REFEED 0x80
+#define GT(next, gesture) (byte)(((GESTURE_STATE_##next) << 4) | (GESTURE_##gesture))
+#define GT_REFEED(next, gesture) (byte)(GESTURE_REFEED | GT(next, gesture))
+
+// next state and gesture for each state and input
+static const byte gestureTransitions[GESTURE_STATES][GESTURE_INPUTS] PROGMEM = {
+    // columns: PRESS, RELEASE, TURN, TIMEOUT inputs
+    {GT(DOWN, NONE),   GT(IDLE, NONE),         GT(IDLE, TURN),          GT(IDLE, NONE)},          // IDLE
+    {GT(DOWN, NONE),   GT(UP, NONE),           GT(ADJUST, PRESS_TURN),  GT(HELD, LONG_PRESS)},    // DOWN
+    {GT(DOWN2, NONE),  GT(UP, NONE),           GT_REFEED(IDLE, CLICK),  GT(IDLE, CLICK)},         // UP (a turn reports the pending click, then turns)
+    {GT(DOWN2, NONE),  GT(IDLE, DOUBLE_CLICK), GT_REFEED(DOWN, CLICK),  GT_REFEED(DOWN, CLICK)},  // DOWN2 (a turn or long hold reports the pending click, then continues as DOWN)
+    {GT(ADJUST, NONE), GT(IDLE, NONE),         GT(ADJUST, PRESS_TURN),  GT(ADJUST, NONE)},        // ADJUST
+    {GT(HELD, NONE),   GT(IDLE, NONE),         GT(ADJUST, PRESS_TURN),  GT(HELD, NONE)},          // HELD
+};
+
+// ms after entering each state before it times out, 0 = never
+static const uint16_t gestureTimeouts[GESTURE_STATES] PROGMEM = {
+    0,                       // IDLE
+    GESTURE_LONG_PRESS_MS,   // DOWN
+    GESTURE_DOUBLE_CLICK_MS, // UP
+    GESTURE_LONG_PRESS_MS,   // DOWN2
+    0,                       // ADJUST
+    0,                       // HELD
+};
+
+static byte gestureState = GESTURE_STATE_IDLE; // current recognizer state
+static uint16_t gestureStateTime = 0;          // scheduler tick the current state was entered
+
+// Apply `input` to the current state, reporting any gesture, and entering the next state at tick `time`
+static void stepGesture(byte input, uint16_t time, int delta)
+{
+    byte transition = pgm_read_byte(&gestureTransitions[gestureState][input]);
+    byte next = (transition >> 4) & 0x07;
+    byte gesture = transition & 0x0F;
+    if (next != gestureState)
+    {
+        gestureState = next;
+        gestureStateTime = time;
+    }
+    if (gesture != GESTURE_NONE)
+    {
+        handleGesture(gesture, gesture >= GESTURE_TURN ? delta : 0);
+    }
+    if (transition & GESTURE_REFEED)
+    {
+        stepGesture(input, time, delta);
+    }
+}
+
+void resetGestures()
+{
+    gestureState = GESTURE_STATE_IDLE;
+}
+
+void feedGesture(byte input, uint16_t time, int delta)
+{
+    checkGestures(time);
+    stepGesture(input, time, delta);
+}
+
+void checkGestures(uint16_t now)
+{
+    uint16_t timeout = pgm_read_word(&gestureTimeouts[gestureState]);
+    if (timeout != 0 && (uint16_t)(now - gestureStateTime) >= timeout)
+    {
+        // timed out at (state entry + timeout), not `now`, so the next state's own timeout isn't delayed by poll latency
+        stepGesture(GESTURE_INPUT_TIMEOUT, gestureStateTime + timeout, 0);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <Arduino.h>
+
+#define GESTURE_LONG_PRESS_MS 2000  // how long, in ms, the switch must be held down (without turning) for a long press
+#define GESTURE_DOUBLE_CLICK_MS 250 // max ms from a click's release to the next press for a double-click. Single clicks are reported once this passes
+
+// gestures, as passed to `handleGesture` (max 16, see gesture.cpp)
+#define GESTURE_NONE 0
+#define GESTURE_CLICK 1        // switch pressed and released (and not pressed again within GESTURE_DOUBLE_CLICK_MS)
+#define GESTURE_DOUBLE_CLICK 2 // switch clicked, then pressed and released again within GESTURE_DOUBLE_CLICK_MS
+#define GESTURE_LONG_PRESS 3   // switch held down for GESTURE_LONG_PRESS_MS, reported while still held
+#define GESTURE_TURN 4         // encoder turned, switch released
+#define GESTURE_PRESS_TURN 5   // encoder turned, switch held down (cancels the long press)
+
+// recognizer inputs, for `feedGesture`
+#define GESTURE_INPUT_PRESS 0   // switch pressed (debounced)
+#define GESTURE_INPUT_RELEASE 1 // switch released (debounced)
+#define GESTURE_INPUT_TURN 2    // encoder turned by `delta`
+#define GESTURE_INPUT_TIMEOUT 3 // current state timed out (fed internally, see `feedGesture`)
+
+// reset the recognizer to idle (switch released, nothing pending)
+void resetGestures();
+// Feed one input into the recognizer, at scheduler tick `time` (see `getSchedulerTicks`), with the encoder
+// `delta` for `GESTURE_INPUT_TURN`. Timeouts due before `time` are applied first, so feed inputs oldest first.
+// Calls `handleGesture` for each gesture recognized
+void feedGesture(byte input, uint16_t time, int delta = 0);
+// Apply any timeout due by scheduler tick `now`, eg for a long press or a pending single click
+void checkGestures(uint16_t now);
+
+// Callback for each recognized gesture (see GESTURE_ types), with the encoder delta for turn gestures (0 otherwise).
+//
+// NOTE: implemented by input.cpp, which routes gestures to the LED and sleep systems
+void handleGesture(byte gesture, int delta);
+
+// error check for timeouts (compared against the 16bit wrapping scheduler tick count)
+#if GESTURE_LONG_PRESS_MS < 1 || GESTURE_LONG_PRESS_MS > 0x7FFF || GESTURE_DOUBLE_CLICK_MS < 1 || GESTURE_DOUBLE_CLICK_MS > 0x7FFF
+#error "GESTURE_LONG_PRESS_MS and GESTURE_DOUBLE_CLICK_MS must be 1-32767ms"
+#endif
+
+#endif // GESTURE_H
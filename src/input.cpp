@@ -1,69 +1,84 @@
 #include "input.h"
 
-#ifdef ENABLE_INPUT
-
-// disable inclusion of unused interrupt pins from EnableInterrupt.h (save space)
-// we are using all external interrupts (8), and pin change interrupts 6 and 7
-// all of these are on port B, so we disable port A
-#define EI_NOTPORTA
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 
-// including EnableInterrupt.h in the header file causes compile errors and for the life of me I can't figure out why
-#include <EnableInterrupt.h>
+#include "profile.h"
 
-static byte _loopIntervalInput = 0; // timer to keep track of loop() intervals for this class
+#ifdef ENABLE_INPUT
 
-static int8_t encPos = 0; // current position of rotary encoder
+// encoder clk/data pins in the Port B pin change mask (PCINT8-11 are PB0-3, so Port B bit numbers carry over to PCMSK1)
+#define ENC_PCINT_MASK ((1 << PORTB_BIT_ENC_DAT) | (1 << PORTB_BIT_ENC_CLK))
 
 volatile bool clearBuffersAndTimers = false; // clear buffers/timers on next cycle (to avoid directly modifying them in sleep/wake cycle)
-volatile bool interruptedBySwitch = false;   // was interrupt via enc switch called before last loop cylce?
-#if defined(POLL_ENCODER_INTERRUPTS) || defined(ENC_ROTATION_WAKES_DEVICE)
-volatile bool interruptedByEncoder = false; // was interrupt via encoder rotation called before last loop cycle?
+
+#ifdef ENC_LONG_PRESS_SLEEPS
+// long press seen, sleep once the switch is released. The switch wakes the device on a LOW level (see enableSwitchWakeInterrupt),
+// so sleeping while it's still held would wake straight back up
+static bool sleepOnRelease = false;
 #endif
 
-#ifdef POLL_ENCODER_INTERRUPTS
-RotaryEncoder *encoder = nullptr;
+#ifdef TRACK_INPUT_LATENCY
+static uint16_t inputEdgeTime = 0; // scheduler tick of the pin edge behind the input being fed to the gesture recognizer
+// start timing latency for a gesture that changes the LEDs, from its input's pin edge (see leds.h)
+#define BEGIN_INPUT_LATENCY() beginInputLatency(inputEdgeTime)
 #else
-RotaryEncoder encoder(PIN_ENC_CLK, PIN_ENC_DAT, ENC_LATCH_MODE);
+#define BEGIN_INPUT_LATENCY()
 #endif
 
-#ifdef USE_ENCODER_SWITCH_LOGIC
-bool encSwitchInputProcessed = false; // was an input processed by all valid sources? flag to prevent multiple firings per input
-byte encSwitchInputDelay = 0;         // forced delay to prevent processing of any switch input
-#ifdef ENCODER_SWITCH_LOGIC_POLL
-bool encSwitchPoll = false;   // is rotary encoder switch currently pressed, as determined by pin polling?
-byte encSwitchPollBuffer = 0; // raw buffer for reading enc switch over several frames following a valid pin poll
-#endif
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-byte encSwitchInterruptBuffer = 0; // raw buffer for reading enc switch for several frames following an interrupt
-#endif
-#if (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0) || (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0)
-int encSwitchHeldTime = 0; // if enc sleep timeout, OR hold switch for button, use `encSwitchHeldTime`
-#if (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0)
-#if (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0)
-int8_t encBrightnessDeltaBuffer = 0;            // tracked delta valueu for enc brightness adjustment, to see about disabling `goToSleep` hold timer
-bool encSleepDisabledByBrightnessDelta = false; // has sleep timeout been disabled by the brightness delta?
-#endif
+// enable the pin change interrupt on the encoder clk/data pins (PCINT1_vect), discarding any change flagged while it was off
+static inline void enableEncoderInterrupt()
+{
+    PCMSK1 |= ENC_PCINT_MASK;
+    GIFR = (1 << PCIF1);
+    GIMSK |= (1 << PCIE1);
+}
+static inline void disableEncoderInterrupt()
+{
+    GIMSK &= ~(1 << PCIE1);
+}
+// enable the encoder switch's INT0 interrupt, sensing a LOW level (ISC01:0 = 0). Edge sensing needs the I/O clock,
+// so only a level interrupt wakes the device from power-down. Disables itself once fired, see ISR(INT0_vect)
+static inline void enableSwitchWakeInterrupt()
+{
+    MCUCR &= ~((1 << ISC01) | (1 << ISC00));
+    GIMSK |= (1 << INT0);
+}
+static inline void disableSwitchWakeInterrupt()
+{
+    GIMSK &= ~(1 << INT0);
+}
 #endif
+
+#ifdef ENABLE_INPUT
+// feed `detents` turned at scheduler tick `time` into the gesture recognizer, as a turn or press-turn (see handleGesture)
+static void feedEncoderTurn(int8_t detents, uint16_t time)
+{
+    // add acceleration or delta multiplier, as needed
+    int delta = detents; // encoder relative motion, in detents
+#ifdef ENC_ROTATION_ACCELERATION
+    // scale by turning speed (time since the previous detent)
+    delta = accelerateEncoderDelta(detents, readEncoderInterval(time));
+#else
+    // no acceleration, check for multplier and proceed
+#ifdef ENC_NONACCEL_MULTIPLIER
+    delta *= ENC_NONACCEL_MULTIPLIER;
 #endif
 #endif
-
+    feedGesture(GESTURE_INPUT_TURN, time, delta);
+}
 #endif
 
 void setupInput()
 {
 #ifdef ENABLE_INPUT
-// create encoder if necessary
-#ifdef POLL_ENCODER_INTERRUPTS
-    encoder = new RotaryEncoder(PIN_ENC_CLK, PIN_ENC_DAT, ENC_LATCH_MODE);
-#endif
-    // encoder switch pin
-    pinMode(PIN_ENC_SWITCH, INPUT_PULLUP);
-    // enable interrupt on enc switch pin
-    enableInterrupt(PIN_ENC_SWITCH | PINCHANGEINTERRUPT, interruptSwitch, FALLING); // TODO: explore getting this working on ONLY falling, seems to be CHANGE atm
+    // encoder pins and decoder state
+    setupEncoder();
+    // encoder switch pin and debouncer (sampled by the scheduler tick, the switch interrupt is only enabled to wake from sleep)
+    setupEncoderSwitch();
     // check for encoder data interrupts
 #if defined(POLL_ENCODER_INTERRUPTS) || defined(ENC_ROTATION_WAKES_DEVICE)
-    enableInterrupt(PIN_ENC_DAT, interruptEncoder, CHANGE);
-    enableInterrupt(PIN_ENC_CLK, interruptEncoder, CHANGE);
+    enableEncoderInterrupt();
 #endif
 #endif
 }
@@ -71,351 +86,181 @@ void setupInput()
 void loopInput()
 {
 #ifdef ENABLE_INPUT
-// check input loop delay
-#if defined(LOOP_INTERVAL_INPUT) && LOOP_INTERVAL_INPUT > 1
-    _loopIntervalInput += DELAY_INTERVAL;
-    if (_loopIntervalInput >= LOOP_INTERVAL_INPUT)
-    {
-        _loopIntervalInput -= LOOP_INTERVAL_INPUT;
-    }
-    else
-    {
-        return;
-    }
-#endif
     // check to clear buffers/timers from a wakeup cycle
     if (clearBuffersAndTimers)
     {
+        clearBuffersAndTimers = false;
 #ifdef USE_ENCODER_SWITCH_LOGIC
-#ifdef ENCODER_SWITCH_LOGIC_POLL
-        encSwitchPollBuffer = 0;
-#if (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0) || (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0)
-        encSwitchHeldTime = 0;
-#if (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0) && (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0)
-        encBrightnessDeltaBuffer = 0;
-        encSleepDisabledByBrightnessDelta = false;
+        resetEncoderSwitch();
 #endif
+#ifdef ENC_LONG_PRESS_SLEEPS
+        sleepOnRelease = false;
 #endif
-#endif
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-        encSwitchInterruptBuffer = 0;
-#endif
-        encSwitchInputDelay = ENCODER_SWITCH_WAKE_INPUT_DELAY;
-#endif
+        resetGestures();
     }
 
-    // prep input state properties
-    bool inputProcessed = false; // was ANY input/interrupt processed this cycle?
-#if defined(POLL_ENCODER_INTERRUPTS) || defined(ENC_ROTATION_WAKES_DEVICE)
-    bool lastInterrupted = interruptedBySwitch || interruptedByEncoder; // was an interrupt received by either switch or encoder?
-#else
-    bool lastInterrupted = interruptedBySwitch; // was an interrupt received by switch?
-#endif
-
-    // check for interrupt since previous cycle
-    if (lastInterrupted)
+    // drain every event queued since the last cycle, oldest first, feeding each into the gesture recognizer
+    // at its own time, so eg a press, turn and release within one cycle is still a press-turn
+    bool inputProcessed = false; // was ANY input processed this cycle?
+#ifdef TRACK_INPUT_LATENCY
+    bool encoderEdgeSeen = false; // was an undecoded encoder event queued this cycle?
+    uint16_t encoderEdgeTime = 0; // scheduler tick of the oldest undecoded encoder event this cycle, for detents decoded below
+#endif
+    inputEvent event;
+    while (popInputEvent(event))
     {
-        // yup, interrupt detected
+        // any turn, press or release counts as input
         inputProcessed = true;
-    }
-
-// read rotary encoder switch
-#ifdef USE_ENCODER_SWITCH_LOGIC
-    bool switchInputReceived = false; // did we fully detect a switch input received by all relevant sources?
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-    // read switch interrupt buffer (read it up here because it gets referenced in multiple places below)
-    if (interruptedBySwitch)
-    {
-        if (encSwitchInputDelay == 0) // confirm input read delay is done
-        {
-            encSwitchInterruptBuffer = ENCODER_SWITCH_INPUT_BUFFER;
-        }
-    }
-    bool encSwitchInterrupt = encSwitchInterruptBuffer > 0;
-#endif
-#ifdef ENCODER_SWITCH_LOGIC_POLL
-    bool lastSwitchPoll = encSwitchPoll; // preserve last switch state
-    if (encSwitchInputDelay == 0)        // confirm input read delay is done
-    {
-        if (!digitalRead(PIN_ENC_SWITCH)) // NC switch, invert
+#ifdef TRACK_INPUT_LATENCY
+        inputEdgeTime = event.time;
+        if (event.type == INPUT_EVENT_ENCODER && !encoderEdgeSeen)
         {
-            encSwitchPollBuffer = ENCODER_SWITCH_INPUT_BUFFER;
+            encoderEdgeSeen = true;
+            encoderEdgeTime = event.time;
         }
-    }
-    encSwitchPoll = encSwitchPollBuffer > 0;
-    if (lastSwitchPoll != encSwitchPoll)
-    {
-        // switch state toggled, do stuff...
-        inputProcessed = true; // confirm input processed
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-        // both poll and interrupt are defined
-    }
-    if (encSwitchInterrupt && encSwitchPoll)
-    {
-        // both interrupted, AND encSwitchPoll is held
-        switchInputReceived = true;
-    }
-    // end combined INTERRUPT + POLL logic
-#else
-        // poll logic only, no switch interrupt
-        if (encSwitchPoll)
-        {
-            // if switch is pressed, confirm we've received input
-            switchInputReceived = true;
-        }
-    } // end ENCODER_SWITCH_LOGIC_POLL only
-#endif
-#else // end ENCODER_SWITCH_LOGIC_POLL (and combined POLL + INTERRUPT logic)
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-    // interrupt logic only, no switch pin polling
-    if (encSwitchInterrupt)
-    {
-        inputProcessed = true; // confirm input processed
-    }
-#else
-#error "neither switch interrupt nor pin polling logic defined, can't read switch input, at least one should be defined, otherwise undefine USE_ENCODER_SWITCH_LOGIC"
-#endif
-#endif
-    // check to see if we're waiting for an input to process, or if we've already received one and are waiting for buffers to clear
-    if (!encSwitchInputProcessed)
-    {
-        // input has NOT YET been processed, check if valid switch input received
-        if (switchInputReceived)
-        {
-#ifdef ENCODER_SWITCH_JUMPS_LEDS
-            // jump LED colour to opposite end of spectrum
-            jumpLEDColor();
 #endif
-            // confirm we've processed the input
-            encSwitchInputProcessed = true;
-        }
-    }
-    else
-    {
-// input HAS been processed, check to see if the buffers are clear and we can reset the input
-#if defined(ENCODER_SWITCH_LOGIC_POLL) && defined(ENCODER_SWITCH_LOGIC_INTERRUPT)
-        // both poll and interrupt defined
-        if (!switchInputReceived && !encSwitchInterrupt && !encSwitchPoll)
+        if (event.type == INPUT_EVENT_ENCODER_UP)
         {
-            encSwitchInputProcessed = false; // all inputs and buffers cleared, reset input process
+            feedEncoderTurn(1, event.time);
         }
-#elif defined(ENCODER_SWITCH_LOGIC_POLL)
-        // poll only
-        if (!switchInputReceived && !encSwitchPoll)
+        else if (event.type == INPUT_EVENT_ENCODER_DOWN)
         {
-            encSwitchInputProcessed = false; // all inputs and buffers cleared, reset input process
+            feedEncoderTurn(-1, event.time);
         }
-#elif defined(ENCODER_SWITCH_LOGIC_INTERRUPT)
-        // interrupt only
-        if (!switchInputReceived && !encSwitchInterrupt)
-        {
-            encSwitchInputProcessed = false; // all inputs and buffers cleared, reset input process
-        }
-#else
-#error "neither switch interrupt nor pin polling logic defined, can't reset input processed, at least one should be defined, otherwise undefine USE_ENCODER_SWITCH_LOGIC"
-#endif // end resetting enc switch input processing
-    }
-    // lastly, decrement input buffers and delays
-#ifdef ENCODER_SWITCH_LOGIC_POLL
-    if (encSwitchPollBuffer > 0)
-    {
-        encSwitchPollBuffer = subtractByte(encSwitchPollBuffer, LOOP_INTERVAL_INPUT);
-        if (encSwitchPollBuffer < 0)
-        {
-            encSwitchPollBuffer = 0;
-        }
-    }
-#endif
-#ifdef ENCODER_SWITCH_LOGIC_INTERRUPT
-    if (encSwitchInterruptBuffer > 0)
-    {
-        encSwitchInterruptBuffer = subtractByte(encSwitchPollBuffer, LOOP_INTERVAL_INPUT);
-        if (encSwitchInterruptBuffer < 0)
+#ifdef USE_ENCODER_SWITCH_LOGIC
+        else if (event.type == INPUT_EVENT_SWITCH_PRESS)
         {
-            encSwitchInterruptBuffer = 0;
+            feedGesture(GESTURE_INPUT_PRESS, event.time);
         }
-    }
-#endif
-    if (encSwitchInputDelay > 0)
-    {
-        encSwitchInputDelay = subtractByte(encSwitchInputDelay, LOOP_INTERVAL_INPUT);
-        if (encSwitchInputDelay < 0)
+        else if (event.type == INPUT_EVENT_SWITCH_RELEASE)
         {
-            encSwitchInputDelay = 0;
-        }
-    }
-
-// track how long encoder input has been held down (requires poll logic) if tracking either hold-to-sleep or hold-to-adj-brightness
-#if (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0) || (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0)
-    if (encSwitchPoll)
-    {
-        // holding switch down
-        encSwitchHeldTime += LOOP_INTERVAL_INPUT;
-#if defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0
-        // check for sleep timeout
-        if (encSwitchHeldTime >= ENC_HELD_SLEEP_TIMEOUT)
-        {
-// ensure sleep timer isn't disabled by brightness delta
-#if defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0
-            if (encSleepDisabledByBrightnessDelta)
+            feedGesture(GESTURE_INPUT_RELEASE, event.time);
+#ifdef ENC_LONG_PRESS_SLEEPS
+            if (sleepOnRelease)
             {
-                // brightness delta held down long enough to disable sleep timeout, just lock the timer
-                encSwitchHeldTime = ENC_HELD_SLEEP_TIMEOUT;
-            }
-            else
-            {
-                // not disabled, and switch held long enough to put device to sleep, nighty night
+                // released after a long press, nighty night. Anything still queued waits for the next cycle, after the wake reset
+                sleepOnRelease = false;
                 goToSleep();
-                // return;
+                return;
             }
-#else
-            // no brightness check, and switch held long enough to put device to sleep, nighty night
-            goToSleep();
-            // return;
 #endif
         }
-#else
-        // not tracking sleep, just brightness adjustment, lock encSwitchHeldTime to ENC_HELD_ADJUST_BRIGHTNESS
-        if (encSwitchHeldTime > ENC_HELD_ADJUST_BRIGHTNESS)
-        {
-            encSwitchHeldTime = ENC_HELD_ADJUST_BRIGHTNESS;
-        }
-#endif // end encSwitchHeldTime checks
-    }
-    else
-    {
-        // switch not held, reset timer
-        encSwitchHeldTime = 0;
-#if (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0) && (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0)
-        // brightness timer defined, ensurue brightness delta buffer also reset
-        encBrightnessDeltaBuffer = 0;
-        encSleepDisabledByBrightnessDelta = false;
 #endif
     }
-#endif
-
-#endif // end USE_ENCODER_SWITCH_LOGIC
 
-    // update and read rotary encoder movement (interrupted)
-#ifdef POLL_ENCODER_INTERRUPTS
-#ifdef POLL_ENCODER_LOOP
-    encoder->tick();
-#endif
-    int8_t newPos = encoder->getPosition();
-#else
-    // update and read rotary encoder movement (non-interrupted)
+    // then any detents that weren't queued (see ISR(PCINT1_vect)), as of now, after everything queued
 #ifdef POLL_ENCODER_LOOP
-    encoder.tick();
-#endif
-    int8_t newPos = encoder.getPosition();
-#endif
-
-    // check for position change
-    if (encPos != newPos)
+    // also decode here, in case an edge was missed (atomic, the interrupt shares decoder state)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-
-        // add acceleration or delta multiplier, as needed
-#ifdef ENC_ROTATION_ACCELERATION
-#ifdef POLL_ENCODER_INTERRUPTS
-        unsigned long ms = encoder->getMillisBetweenRotations();
-#else
-        unsigned long ms = encoder.getMillisBetweenRotations();
-#endif
-        if (ms < longCutoff)
-        {
-            // do some acceleration using factors a and b
-            // limit to maximum acceleration
-            if (ms < shortCutoff)
-            {
-                ms = shortCutoff;
-            }
-            float ticksActual_float = a * ms + b;
-            long deltaTicks = (long)ticksActual_float * (newPos - encPos);
-            newPos = newPos + deltaTicks;
-            // update encorder position to newPos
-#ifdef POLL_ENCODER_INTERRUPTS
-            encoder->setPosition(newPos);
-#else
-            encoder.setPosition(newPos);
-#endif
-            // done accounting for ms cutoff, calc delta
-        }
-        // position changed, read movement delta
-        int delta = encPos - newPos; // encoder relative motion
-#else
-        // no acceleration, calc delta, check for multplier and proceed
-        int delta = encPos - newPos; // encoder relative motion
-#ifdef ENC_NONACCEL_MULTIPLIER
-        delta *= ENC_NONACCEL_MULTIPLIER;
-#endif
-#endif
-
-        // check for delta
-        if (delta != 0)
-        {
-            // update LED colour/brightness by delta amount
-#if defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0
-            if (encSwitchHeldTime >= ENC_HELD_ADJUST_BRIGHTNESS)
-            {
-                // enc switch is held, adjust brightness
-                shiftLEDBrightness(delta);
-#if (defined(ENC_HELD_ADJUST_BRIGHTNESS) && ENC_HELD_ADJUST_BRIGHTNESS > 0) && (defined(ENC_HELD_SLEEP_TIMEOUT) && ENC_HELD_SLEEP_TIMEOUT > 0)
-                // track brightness delta to check for sleep timeout disable
-                encBrightnessDeltaBuffer += delta;
-                if (abs(encBrightnessDeltaBuffer) >= ENC_ADJUST_BRIGHTNESS_AMT_DISABLES_SLEEP)
-                {
-                    // yup, brightness has changed sufficiently to disable sleep timeout
-                    encSleepDisabledByBrightnessDelta = true;
-                }
+        PROFILE_BEGIN(PROFILE_ENCODER_POLL);
+        holdEncoderDetent(tickEncoder());
+        PROFILE_END(PROFILE_ENCODER_POLL);
+    }
 #endif
-            }
-            else
-            {
-                // enc switch not held, adjust colour
-                shiftLEDColor(delta);
-            }
-#else
-            // update LED colour only
-            shiftLEDColor(delta);
+    int8_t held = readEncoderDelta();
+    if (held != 0)
+    {
+        uint16_t now = getSchedulerTicks();
+#ifdef TRACK_INPUT_LATENCY
+        // time the turn from the first undecoded encoder edge (or now, if there wasn't one)
+        inputEdgeTime = encoderEdgeSeen ? encoderEdgeTime : now;
 #endif
-            // confirm input processed
-            inputProcessed = true;
-        }
-
-        // update stored encoder position
-        encPos = newPos;
+        feedEncoderTurn(held, now);
+        // confirm input processed
+        inputProcessed = true;
     }
+    // keep the detent timestamp from wrapping while the encoder is idle (see ageEncoder)
+    ageEncoder();
+
+    // report any gesture that has timed out (long press, or a click that wasn't a double-click)
+    checkGestures(getSchedulerTicks());
 
     if (inputProcessed)
     {
         // reset sleep timer
         resetSleepTimer();
     }
+#endif // ENABLE_INPUT
+}
 
-    // reset interrupted state
-    if (lastInterrupted)
+#ifdef ENABLE_INPUT
+void handleGesture(byte gesture, int delta)
+{
+    if (gesture == GESTURE_TURN)
     {
-        interruptedBySwitch = false;
-#if defined(POLL_ENCODER_INTERRUPTS) || defined(ENC_ROTATION_WAKES_DEVICE)
-        interruptedByEncoder = false;
+        BEGIN_INPUT_LATENCY();
+        shiftLEDColor(delta);
+    }
+    else if (gesture == GESTURE_PRESS_TURN)
+    {
+        BEGIN_INPUT_LATENCY();
+#ifdef ENC_LONG_PRESS_SLEEPS
+        // turning after a long press cancels its sleep
+        sleepOnRelease = false;
+#endif
+#ifdef ENC_PRESS_TURN_BRIGHTNESS
+        shiftLEDBrightness(delta);
+#else
+        shiftLEDColor(delta);
 #endif
     }
-#endif // ENABLE_INPUT
+#ifdef ENCODER_SWITCH_JUMPS_LEDS
+    else if (gesture == GESTURE_CLICK)
+    {
+        // jump LED colour to opposite end of spectrum
+        BEGIN_INPUT_LATENCY();
+        jumpLEDColor();
+    }
+#endif
+#ifdef ENC_DOUBLE_CLICK_TESTS_LEDS
+    else if (gesture == GESTURE_DOUBLE_CLICK)
+    {
+        BEGIN_INPUT_LATENCY();
+        testLEDColor();
+    }
+#endif
+#ifdef ENC_LONG_PRESS_SLEEPS
+    else if (gesture == GESTURE_LONG_PRESS)
+    {
+        // switch held long enough to put device to sleep, once it's released (see loopInput)
+        sleepOnRelease = true;
+    }
+#endif
 }
 
-#ifdef ENABLE_INPUT
-void interruptSwitch()
+//
+// ------------------------------------------------------------ [  INTERRUPTS  ] ---------
+//
+
+// encoder switch, only enabled while asleep
+ISR(INT0_vect)
 {
-    interruptedBySwitch = true;
+    // the interrupt itself wakes the device, so just disarm it: a level interrupt keeps firing for as long as the switch is held.
+    // the press is then debounced and queued by the scheduler tick, like any other
+    PROFILE_BEGIN(PROFILE_SWITCH_ISR);
+    GIMSK &= ~(1 << INT0);
+    PROFILE_END(PROFILE_SWITCH_ISR);
 }
 
 #if defined(POLL_ENCODER_INTERRUPTS) || defined(ENC_ROTATION_WAKES_DEVICE)
-void interruptEncoder()
+// encoder clk/data pin change. PCMSK1 only has the encoder pins set, so any change here is an encoder edge
+ISR(PCINT1_vect)
 {
-    interruptedByEncoder = true;
+    PROFILE_BEGIN(PROFILE_ENCODER_ISR);
 #ifdef POLL_ENCODER_INTERRUPTS
-    encoder->tick();
+    // decode, and only queue an event per detent (not per edge), so fast spins can't flood the queue
+    int8_t detent = tickEncoder();
+    if (detent != 0 && !pushInputEvent(detent > 0 ? INPUT_EVENT_ENCODER_UP : INPUT_EVENT_ENCODER_DOWN))
+    {
+        // queue full, hold the detent for loopInput rather than losing it (fed after the queue, out of order)
+        holdEncoderDetent(detent);
+    }
+#else
+    // not decoding here, interrupt only wakes the device (decoded in loopInput)
+    pushInputEvent(INPUT_EVENT_ENCODER);
 #endif
+    PROFILE_END(PROFILE_ENCODER_ISR);
 }
 #endif
 #endif
@@ -425,14 +270,13 @@ void sleepInput()
 #ifdef ENABLE_INPUT
     // reset switch timers and input buffers
     clearBuffersAndTimers = true;
-// disable interrupts as needed
-#ifndef ENC_SWITCH_WAKES_DEVICE
-    disableInterrupt(PIN_ENC_SWITCH | PINCHANGEINTERRUPT);
+// enable wake interrupts, and disable others, as needed
+#ifdef ENC_SWITCH_WAKES_DEVICE
+    enableSwitchWakeInterrupt();
 #endif
 #ifndef ENC_ROTATION_WAKES_DEVICE
 #ifdef POLL_ENCODER_INTERRUPTS
-    disableInterrupt(PIN_ENC_DAT);
-    disableInterrupt(PIN_ENC_CLK);
+    disableEncoderInterrupt();
 #endif
 #endif
 #endif
@@ -440,33 +284,16 @@ void sleepInput()
 void wakeInput()
 {
 #ifdef ENABLE_INPUT
-// re-enable interrupts
-#ifndef ENC_SWITCH_WAKES_DEVICE
-    enableInterrupt(PIN_ENC_SWITCH | PINCHANGEINTERRUPT, interruptSwitch, FALLING);
+// disable wake interrupts, and re-enable others, as needed
+#ifdef ENC_SWITCH_WAKES_DEVICE
+    disableSwitchWakeInterrupt(); // (if not already disarmed by its own interrupt, ie woken some other way)
 #endif
 #ifndef ENC_ROTATION_WAKES_DEVICE
 #ifdef POLL_ENCODER_INTERRUPTS
-    enableInterrupt(PIN_ENC_DAT, interruptEncoder, CHANGE);
-    enableInterrupt(PIN_ENC_CLK, interruptEncoder, CHANGE);
+    enableEncoderInterrupt();
 #endif
 #endif
     // ensure clear buffers is still true, post wakeup, for next cycle
     clearBuffersAndTimers = true;
 #endif
-}
-bool validWakeUp()
-{
-#ifdef ENABLE_INPUT
-// check valid wakeup types
-#ifdef ENC_SWITCH_WAKES_DEVICE
-    // at least, check for that
-    if (interruptedBySwitch)
-    {
-        // check for invalid switch timing
-        // TODO: invalid sw time
-    }
-#endif
-#endif
-    // the only invalid circumstance involves the switch, and we checked for that, return true
-    return true;
 }
\ No newline at end of file
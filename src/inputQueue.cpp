@@ -0,0 +1,68 @@
+#include "inputQueue.h"
+
+#include "scheduler.h"
+
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+// compiler barrier, keeps event slot reads/writes on the correct side of the head/tail index updates
+#define INPUT_QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static inputEvent inputQueue[INPUT_QUEUE_SIZE];
+static volatile byte inputQueueHead = 0;      // next slot to write, only modified by interrupts (producer)
+static volatile byte inputQueueTail = 0;      // next slot to read, only modified by main loop (consumer)
+#ifdef TRACK_INPUT_QUEUE_STATS
+static volatile byte inputQueueOverflows = 0; // events dropped because the queue was full
+#endif
+
+bool pushInputEvent(byte type)
+{
+    byte head = inputQueueHead;
+    byte next = (head + 1) & INPUT_QUEUE_MASK;
+    if (next == inputQueueTail)
+    {
+        // queue full, drop the event
+#ifdef TRACK_INPUT_QUEUE_STATS
+        if (inputQueueOverflows < UINT8_MAX)
+        {
+            inputQueueOverflows++;
+        }
+#endif
+        return false;
+    }
+    inputQueue[head].type = type;
+    inputQueue[head].time = getSchedulerTicks();
+    INPUT_QUEUE_BARRIER(); // event must be fully written before it's published
+    inputQueueHead = next;
+    return true;
+}
+
+// Copy the oldest event into `event` without removing it, returning `false` if the queue is empty
+static inline bool peekInputEvent(inputEvent &event)
+{
+    byte tail = inputQueueTail;
+    if (tail == inputQueueHead)
+    {
+        return false; // queue empty
+    }
+    INPUT_QUEUE_BARRIER(); // don't read the slot before checking the head
+    event = inputQueue[tail];
+    return true;
+}
+
+bool popInputEvent(inputEvent &event)
+{
+    if (!peekInputEvent(event))
+    {
+        return false;
+    }
+    INPUT_QUEUE_BARRIER(); // event must be fully read before its slot is released
+    inputQueueTail = (inputQueueTail + 1) & INPUT_QUEUE_MASK;
+    return true;
+}
+
+#ifdef TRACK_INPUT_QUEUE_STATS
+byte getInputEventOverflows()
+{
+    return inputQueueOverflows;
+}
+#endif
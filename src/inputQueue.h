@@ -0,0 +1,44 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <Arduino.h>
+
+#include "pindef.h"
+
+#define INPUT_QUEUE_SIZE 8 // size of the interrupt-to-loopInput() event ring buffer, must be a power of 2 (holds SIZE - 1 events)
+
+// #define TRACK_INPUT_QUEUE_STATS // count events that didn't fit in the queue, see `getInputEventOverflows`
+
+// input event types, pushed by the interrupts that raised them
+#define INPUT_EVENT_SWITCH_PRESS 0   // encoder switch pressed (debounced, see encoderSwitch.h)
+#define INPUT_EVENT_ENCODER 1        // encoder clk/data pin changed, not decoded (without POLL_ENCODER_INTERRUPTS, decoded in loopInput instead)
+#define INPUT_EVENT_SWITCH_RELEASE 2 // encoder switch released (debounced, see encoderSwitch.h)
+#define INPUT_EVENT_ENCODER_UP 3     // encoder turned one detent, positive direction (see tickEncoder)
+#define INPUT_EVENT_ENCODER_DOWN 4   // encoder turned one detent, negative direction
+
+// container for a single input event, as recorded by an interrupt
+struct inputEvent
+{
+    byte type;     // what raised this event, see INPUT_EVENT_ types
+    uint16_t time; // scheduler tick (ms) when the interrupt fired, see `getSchedulerTicks`
+};
+
+// Push an event of the given type onto the queue, timestamped.
+//
+// IMPORTANT: only call from interrupts. The queue is lock-free single-producer/single-consumer,
+// and since AVR interrupts don't nest, every interrupt together counts as the single producer.
+// If the queue is full, the event is dropped (counted with TRACK_INPUT_QUEUE_STATS), and `false` is returned.
+bool pushInputEvent(byte type);
+// Pop the oldest event into `event`, returning `false` if the queue is empty. Only call from the main loop
+bool popInputEvent(inputEvent &event);
+#ifdef TRACK_INPUT_QUEUE_STATS
+// Returns the number of events that didn't fit because the queue was full (saturates at 255). Includes encoder detents, which are held instead, see `holdEncoderDetent`
+byte getInputEventOverflows();
+#endif
+
+// error check for queue size
+#if INPUT_QUEUE_SIZE < 2 || INPUT_QUEUE_SIZE > 128 || (INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) != 0
+#error "INPUT_QUEUE_SIZE must be a power of 2, between 2 and 128"
+#endif
+
+#endif // INPUTQUEUE_H
@@ -1,29 +1,49 @@
 #include "leds.h"
 
-static byte _loopIntervalLEDs = 0; // timer to keep track of loop() intervals for this class
-
 static bool savedLEDsThisSession = false; // on first save, ensure LEDs are updated correctly only once
 
-volatile bool queueUpdateLEDs = false; // if true, calls `updateLEDs()` at the start of the next `loopLEDs` cycle
+volatile bool queueUpdateLEDs = false; // if true, calls `updateLEDs()` at the end of the next `loopLEDs` cycle (see `requestLEDUpdate`)
 
-CRGB leds[NUM_LEDS];
+#ifndef LED_STREAM_PIXELS
+CRGB leds[NUM_LEDS]; // the ONE frame buffer, every render path writes directly into it (see LED_FRAME_BUFFER_MAX_BYTES)
+#if defined(ENABLE_ANIMATION) && defined(ADVANCED_ANIMATION) && !defined(LED_FLICKER_PER_PIXEL)
+#define RENDER_BRIGHTNESS_ROW // buffered frames fetch the whole ByteDrifter brightness row at once, rather than via `renderPixel`
+#endif
+#endif
+static CRGB hueRow; // current frame's LED colour, at full brightness, see `beginFrame`
 static byte ledColor = DATA_DEFAULT_LED_HUE; // current LED HSV hue
 
 static byte ledBrightness = 255; // 0-255, 0 = `LED_MIN_BRIGHTNESS`, 255 = 255, capped by `FastLED.setBrightness(LED_MAX_BRIGHTNESS)`
 
 bool clearLEDs = false; // should LEDs be cleared on next updateLEDs() call?
 
+
+#ifdef TRACK_LED_STATS
+ledStats stats;
+#endif
+
+#ifdef TRACK_INPUT_LATENCY
+inputLatencyStats inputLatency;
+static bool inputLatencyPending = false; // is an input waiting to be shown?
+static uint16_t inputLatencyEdge = 0;    // scheduler tick of the pending input's pin edge
+#endif
+
 #ifdef ENABLE_ANIMATION
 Random16 rng; // random number generator
-static CRGB colorsArray[NUM_LEDS];
-int animTimer = 0;
+static uint16_t frameClockTick = 0; // scheduler tick of the last frame clock update
+static uint16_t frameClock = 0;     // fixed timestep accumulator, in ms * ANIM_FPS (so ANIM_FRAME_UNITS = one frame)
 #ifdef ADVANCED_ANIMATION
-ByteDrifter byteDrifter(rng);
+#ifdef LED_FLICKER_PER_PIXEL
+ByteDrifterBank<NUM_LEDS> byteDrifterBank(rng); // one brightness channel per LED
+#else
+ByteDrifter<> byteDrifter(rng);
+#endif
 #else
 byte brightnessFalloffValue = BRIGHTNESS_FALLOFF_MAX;  // actual value that brightness falls off
 byte brightnessFalloffTarget = BRIGHTNESS_FALLOFF_MAX; // target value for brightness falloff
 byte brightnessInterval = 0;                           // ticks (in anim fps) until next brightness falloff randomization
 byte brightnessSpeed = BRIGHTNESS_FALLOFF_SPEED_MIN;   // speed (in byte units/frame) brightnessFalloffValue moves to target
+static byte falloffBrightness = 0;                     // brightness of the next pixel rendered this frame
 #endif
 #endif
 
@@ -40,12 +60,19 @@ void setupLEDs()
 {
 // prep LEDs
 #ifdef CALL_FASTLED_METHODS
+#ifdef LED_OUTPUT_USI
+    // USI output, FastLED is only used for colour math (brightness is applied during output)
+    setupLEDsUSI();
+#else
     FastLED.setBrightness(LED_MAX_BRIGHTNESS);
+    // no temporal dithering, so a frame looks the same no matter how often it's shown (unchanged frames are skipped)
+    FastLED.setDither(DISABLE_DITHER);
     FastLED.addLeds<CHIPSET, PIN_LED_DATA, RGB_ORDER>(leds, NUM_LEDS);
 
 #ifdef LED_MAX_MILLIAMP_DRAW
     FastLED.setMaxPowerInVoltsAndMilliamps(5, LED_MAX_MILLIAMP_DRAW);
 #endif
+#endif
 #endif
 
     // clear LED local data
@@ -55,8 +82,10 @@ void setupLEDs()
     loadLEDData();
 
 // init random seed
-#ifdef ENABLE_ANIMATION
-    rng.setSeed(analogRead(PIN_RANDOMSEED));
+#if defined(ENABLE_ANIMATION) && defined(ANIMATION_REPLAY_SEED)
+    seedAnimation(ANIMATION_REPLAY_SEED);
+#elif defined(ENABLE_ANIMATION)
+    seedAnimation(analogRead(PIN_RANDOMSEED));
 #endif
 
     // initial update (failsafe, technically called in main as well)
@@ -66,18 +95,6 @@ void setupLEDs()
 
 void loopLEDs()
 {
-// check LEDs loop delay
-#if defined(LOOP_INTERVAL_LEDS) && LOOP_INTERVAL_LEDS > 1
-    _loopIntervalLEDs += DELAY_INTERVAL;
-    if (_loopIntervalLEDs >= LOOP_INTERVAL_LEDS)
-    {
-        _loopIntervalLEDs -= LOOP_INTERVAL_LEDS;
-    }
-    else
-    {
-        return;
-    }
-#endif
 // check debug flash
 #ifdef DEBUG_FLASH_LED_0
     debugFlashTimer += LOOP_INTERVAL_LEDS;
@@ -89,87 +106,291 @@ void loopLEDs()
     }
 #endif
 #ifdef ENABLE_ANIMATION
-    // run animation
-    // check timer
-    animTimer += LOOP_INTERVAL_LEDS;
-    if (animTimer >= ANIM_FPS)
+    // run animation on a fixed timestep: accumulate real elapsed time, and step one
+    // animation frame per 1/ANIM_FPS second, regardless of how often this is called
+    uint16_t now = getSchedulerTicks();
+    uint16_t elapsed = now - frameClockTick;
+    frameClockTick = now;
+    if (elapsed > ANIM_MAX_ELAPSED_MS)
+    {
+#ifdef TRACK_LED_STATS
+        // frames that fell in the discarded time were never rendered either
+        stats.framesDropped += ((uint32_t)(elapsed - ANIM_MAX_ELAPSED_MS) * ANIM_FPS) / ANIM_FRAME_UNITS;
+#endif
+        elapsed = ANIM_MAX_ELAPSED_MS; // limit catch-up after a long stall (any time past this is dropped)
+    }
+    frameClock += elapsed * ANIM_FPS;
+    if (frameClock < ANIM_FRAME_UNITS)
     {
-        // reset anim timer, and animate LEDs
-        animTimer -= ANIM_FPS;
-        animateLEDs();
+        return; // not at a frame boundary yet, any queued update waits for it
     }
+#ifdef TRACK_LED_STATS
+    uint16_t frameStart = micros();
 #endif
-    // check for queued LED update (probably from a wake cycle, or debug flash)
+    // step every frame that's due, up to the catch-up limit, then render once
+    byte steps = 0;
+    while (frameClock >= ANIM_FRAME_UNITS)
+    {
+        frameClock -= ANIM_FRAME_UNITS;
+        if (steps < ANIM_MAX_CATCHUP_FRAMES)
+        {
+            PROFILE_BEGIN(PROFILE_ANIMATE_LEDS);
+            animateLEDs();
+            PROFILE_END(PROFILE_ANIMATE_LEDS);
+        }
+        steps++;
+    }
+#endif
+    // check for queued LED update (from animation, input, a wake cycle, or debug flash),
+    // so no matter how many requests came in since the last cycle, render at most once per frame
     if (queueUpdateLEDs)
     {
         updateLEDs();
     }
+#if defined(ENABLE_ANIMATION) && defined(TRACK_LED_STATS)
+    // frame stats
+    uint16_t frameTime = (uint16_t)micros() - frameStart;
+    if (frameTime > stats.worstFrameMicros)
+    {
+        stats.worstFrameMicros = frameTime;
+    }
+    stats.framesRendered++;
+    stats.framesDropped += steps - 1; // every frame due beyond the one rendered was never shown
+#endif
 }
 
 //
 // ------------------------------------------------------------ [  LED DISPLAY LOGIC  ] ---------
 //
 
-void updateLEDs()
+#ifdef LED_STREAM_PIXELS
+// Returns true if the frame about to be streamed differs from the last one, and records it as shown.
+// No frame buffer to compare when streaming, but frames are a pure function of these inputs,
+// so comparing them exactly is equivalent (streaming only builds with one shared brightness per frame, see leds.h)
+static bool frameChanged()
+{
+    byte inputs[] = {
+        clearLEDs,
+        ledColor,
+        ledBrightness,
+#ifdef ENABLE_ANIMATION
+        byteDrifter.getActualValue(),
+#endif
+#ifdef DEBUG_FLASH_LED_0
+        debugFlashOn,
+#endif
+    };
+    static byte shownInputs[sizeof(inputs)]; // inputs of the last frame streamed
+    bool changed = memcmp(inputs, shownInputs, sizeof(inputs)) != 0;
+    memcpy(shownInputs, inputs, sizeof(inputs));
+    return changed;
+}
+#endif
+
+// Returns full saturation/brightness colour `hueRow` dimmed to HSV value `brightness`.
+// Bit-identical to `CRGB(CHSV(hue, 255, brightness))`, as FastLED's rainbow hsv2rgb applies
+// value the same way (squared via scale8_video, then scale8 per channel), at a fraction of the cost
+static inline CRGB dimHueRow(CRGB hueRow, byte brightness)
+{
+    return hueRow.nscale8(scale8_video(brightness, brightness));
+}
+
+// prep per-frame render state for `renderPixel`, call once before rendering each frame
+static void beginFrame()
 {
-    // first, check if we're clearing LEDs
     if (clearLEDs)
     {
-        for (byte i = 0; i < NUM_LEDS; i++)
-        {
+        return; // clearing LEDs, nothing to prep
+    }
+    // all LEDs share one hue, so convert it to RGB once per frame, and only dim it per pixel
+    hueRow = CRGB(CHSV(ledColor, 255, 255));
+#ifdef LED_OUTPUT_USI
+    // no `FastLED.setBrightness` for USI output, so apply the max brightness here, once per frame,
+    // rather than per pixel during output (where multiplies would stretch the gaps between bytes)
+    hueRow.nscale8(LED_MAX_BRIGHTNESS);
+#endif
+    // check if anim is enabled
 #ifdef ENABLE_ANIMATION
-            colorsArray[i] = CRGB::Black;
+    // animation is enabled
+#if defined(ADVANCED_ANIMATION) && !defined(LED_FLICKER_PER_PIXEL)
+    // reset iteration HERE, so every render (at most one per frame, see `loopLEDs`)
+    // starts from the same iteration, and LED color changes don't decay it further
+    byteDrifter.resetIteration();
+#elif !defined(ADVANCED_ANIMATION)
+    falloffBrightness = ledBrightness;
+#endif
+#else
+    // no animation, every pixel is identical
+    hueRow = dimHueRow(hueRow, ledBrightness);
+#endif
+#if defined(LED_STREAM_SHARED_BRIGHTNESS) && defined(ENABLE_ANIMATION)
+    // every pixel shares the drifter's brightness this frame, so dim once here, and streamed
+    // pixels are just copies, keeping the gap between them short (see LED_STREAM_GAP_US)
+    byte brightness = byteDrifter.getValue(false);
+    hueRow = brightness >= LED_MIN_BRIGHTNESS ? dimHueRow(hueRow, brightness) : CRGB(CRGB::Black);
 #endif
-            leds[i] = CRGB::Black;
+}
+
+// Returns pixel `index` of the current frame, at the given animation `brightness`
+static CRGB shadePixel(uint16_t index, byte brightness)
+{
+    CRGB pixel = CRGB::Black;
+    // check if we're clearing LEDs
+    if (!clearLEDs)
+    {
+#if defined(ENABLE_ANIMATION) && !defined(LED_STREAM_SHARED_BRIGHTNESS)
+#ifdef ADVANCED_ANIMATION
+        // advanced animation using byteDrifter for brightness
+        // apply colour if brightness exceeds min value, otherwise, leave black
+        if (brightness >= LED_MIN_BRIGHTNESS)
+        {
+            pixel = dimHueRow(hueRow, brightness);
         }
+#else
+        pixel = dimHueRow(hueRow, brightness);
+#endif
+#else
+        (void)brightness;
+        pixel = hueRow; // already dimmed, see `beginFrame`
+#endif
     }
-    else
+    // check for debug LED flashing
+#ifdef DEBUG_FLASH_LED_0
+    if (index == 0)
     {
-        // not clearing LEDs, check if anim is enabled
+        pixel = debugFlashOn && !clearLEDs ? CRGB::Red : CRGB::Black;
+#ifdef LED_OUTPUT_USI
+        pixel.nscale8(LED_MAX_BRIGHTNESS); // as `hueRow`, see `beginFrame`
+#endif
+    }
+#else
+    (void)index; // only needed for debug flashing
+#endif
+    return pixel;
+}
+
+#ifndef RENDER_BRIGHTNESS_ROW
+// Returns the colour of pixel `index` for the current frame. Must be called for every
+// index in order, from 0 to NUM_LEDS - 1, once per frame after `beginFrame`.
+// Renders into `leds`, or straight out to the strip with LED_STREAM_PIXELS
+static CRGB renderPixel(uint16_t index)
+{
 #ifdef ENABLE_ANIMATION
-        // animation is enabled
-#ifdef ADVANCED_ANIMATION
-        // reset iteration HERE, so we don't duplicate iterations if we only change LED color
-        // (and thus cause iteration decay multiple times per animation frame)
-        byteDrifter.resetIteration();
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+    return shadePixel(index, byteDrifterBank.getValue(index));
+#elif defined(ADVANCED_ANIMATION)
+    return shadePixel(index, byteDrifter.getValue());
 #else
-        byte brightness = ledBrightness;
+    byte brightness = falloffBrightness;
+    falloffBrightness = subtractByte(falloffBrightness, brightnessFalloffValue);
+    return shadePixel(index, brightness);
 #endif
-        for (byte i = 0; i < NUM_LEDS; i++)
-        {
-#ifdef ADVANCED_ANIMATION
-            // advanced animation using byteDrifter for brightness
-            byte brightness = byteDrifter.getValue();
-            // apply colour if brightness exceeds min value, otherwise, set black
-            colorsArray[i] = brightness >= LED_MIN_BRIGHTNESS ? CRGB(CHSV(ledColor, 255, brightness)) : CRGB::Black;
 #else
-            colorsArray[i] = CRGB(CHSV(ledColor, 255, brightness));
-            brightness = subtractByte(brightness, brightnessFalloffValue);
+    return shadePixel(index, ledBrightness);
 #endif
+}
+#endif
+
+void updateLEDs()
+{
+    PROFILE_BEGIN(PROFILE_UPDATE_LEDS);
+    beginFrame();
+#ifndef LED_STREAM_PIXELS
+    // render straight into the FastLED buffer, noting any change as we go. `leds` still holds the last frame shown
+    // (every changed frame is shown, below), so comparing in place is exact, without keeping a copy of it
+    bool changed = false;
+#ifdef RENDER_BRIGHTNESS_ROW
+    // fetch the whole brightness row from byteDrifter in one call
+    byte brightnessRow[NUM_LEDS];
+    byteDrifter.getValues(brightnessRow, NUM_LEDS);
+    for (ledIndex i = 0; i < NUM_LEDS; i++)
+    {
+        CRGB pixel = shadePixel(i, brightnessRow[i]);
+        if (leds[i] != pixel)
+        {
+            changed = true;
+            leds[i] = pixel;
         }
-        for (byte i = 0; i < NUM_LEDS; i++)
+    }
+#else
+    for (ledIndex i = 0; i < NUM_LEDS; i++)
+    {
+        CRGB pixel = renderPixel(i);
+        if (leds[i] != pixel)
         {
-            leds[i] = colorsArray[i];
+            changed = true;
+            leds[i] = pixel;
         }
+    }
+#endif
+#endif
+// update FastLED strip, only if the frame has changed (strip output disables interrupts, so skip it whenever possible)
+#ifdef CALL_FASTLED_METHODS
+#ifdef LED_STREAM_PIXELS
+    bool changed = frameChanged(); // always check, so the shown frame is recorded even when clearing
+#endif
+    if (clearLEDs || changed)
+    {
+        // always push cleared frames, see `clearLEDLocalData`
+        PROFILE_BEGIN(PROFILE_LED_OUTPUT);
+#if defined(LED_STREAM_PIXELS)
+        streamLEDsUSI(renderPixel, NUM_LEDS);
+#elif defined(LED_OUTPUT_USI)
+        showLEDsUSI(leds, NUM_LEDS);
 #else
-        for (byte i = 0; i < NUM_LEDS; i++)
+        FastLED.show();
+#endif
+        PROFILE_END(PROFILE_LED_OUTPUT);
+#ifdef TRACK_LED_STATS
+        stats.showsIssued++;
+#endif
+#ifdef TRACK_INPUT_LATENCY
+        // output done, the pending input is now visible
+        if (inputLatencyPending)
         {
-            leds[i] = CRGB(CHSV(ledColor, 255, ledBrightness));
+            uint16_t latency = getSchedulerTicks() - inputLatencyEdge;
+            uint16_t bucket = latency / INPUT_LATENCY_BUCKET_MS;
+            if (bucket >= INPUT_LATENCY_BUCKETS)
+            {
+                bucket = INPUT_LATENCY_BUCKETS - 1;
+            }
+            if (inputLatency.counts[bucket] < UINT16_MAX)
+            {
+                inputLatency.counts[bucket]++;
+            }
+            if (latency > inputLatency.worstMillis)
+            {
+                inputLatency.worstMillis = latency;
+            }
+            inputLatencyPending = false;
         }
 #endif
     }
-    // check for debug LED flashing
-#ifdef DEBUG_FLASH_LED_0
-    leds[0] = debugFlashOn && !clearLEDs ? CRGB::Red : CRGB::Black;
+#if defined(TRACK_LED_STATS) || defined(TRACK_INPUT_LATENCY)
+    else
+    {
+#ifdef TRACK_LED_STATS
+        stats.showsSkipped++;
 #endif
-// update FastLED strip
-#ifdef CALL_FASTLED_METHODS
-    FastLED.show();
+#ifdef TRACK_INPUT_LATENCY
+        // frame unchanged, the pending input had no visible effect, don't record it
+        inputLatencyPending = false;
+#endif
+    }
+#endif
+#elif !defined(LED_STREAM_PIXELS)
+    (void)changed; // only needed for output
 #endif
     // reset clear LEDs
     clearLEDs = false;
     // reset update LEDs queue
     queueUpdateLEDs = false;
+    PROFILE_END(PROFILE_UPDATE_LEDS);
+}
+
+void requestLEDUpdate()
+{
+    queueUpdateLEDs = true;
 }
 
 void shiftLEDColor(byte delta)
@@ -179,11 +400,11 @@ void shiftLEDColor(byte delta)
         return;
     }
     ledColor += delta;
-    updateLEDs();
+    requestLEDUpdate();
     saveLEDData();
 }
 
-void shiftLEDBrightness(byte delta)
+void shiftLEDBrightness(int delta)
 {
     if (delta == 0)
     {
@@ -194,7 +415,7 @@ void shiftLEDBrightness(byte delta)
     {
         ledBrightness = LED_MIN_BRIGHTNESS;
     }
-    updateLEDs();
+    requestLEDUpdate();
 }
 
 void jumpLEDColor()
@@ -205,30 +426,28 @@ void jumpLEDColor()
 void testLEDColor()
 {
     ledColor = 0;
-    updateLEDs();
+    requestLEDUpdate();
 }
 
 #ifdef ENABLE_ANIMATION
 void animateLEDs()
 {
     // animation step
-#ifdef ADVANCED_ANIMATION
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+    PROFILE_BEGIN(PROFILE_DRIFTER_TICK);
+    byteDrifterBank.tick();
+    PROFILE_END(PROFILE_DRIFTER_TICK);
+#elif defined(ADVANCED_ANIMATION)
+    PROFILE_BEGIN(PROFILE_DRIFTER_TICK);
     byteDrifter.tick(false);
+    PROFILE_END(PROFILE_DRIFTER_TICK);
 #else
     // decrement interval
     if (brightnessInterval == 0)
     {
         // interval has reached zero, re-randomize target values
-        uint16_t value = rng.get();     // generate a random number between 0-65535
-        float p = value / (float)65535; // convert to float between 0.00 and 1.00
-        // p = pow(p, BRIGHTNESS_CURVE_POWER); // multiply p to a power of itself to curve
-        for (byte b = 0; b < BRIGHTNESS_CURVE_POWER; b++)
-        {
-            p *= p; // using pow used a bunch of space, just write it manually =_=
-        }
-        byte randomByte = byte((254.5 * p) + 0.5); // convert random 0.0-1.0 float to 0-255 byte
-        // assign brightnessFalloffTarget, mapped from 0-255 to falloff min/max
-        brightnessFalloffTarget = map(randomByte, 0, 255, BRIGHTNESS_FALLOFF_MIN, BRIGHTNESS_FALLOFF_MAX);
+        // assign brightnessFalloffTarget from a random byte, curved and mapped to falloff min/max via a PROGMEM table
+        brightnessFalloffTarget = ByteTable<CurvedLerpGenerator<BRIGHTNESS_CURVE_POWER, BRIGHTNESS_FALLOFF_MIN, BRIGHTNESS_FALLOFF_MAX>>::get(rng.get() >> 8);
         // re-randomize speed and interval
         brightnessSpeed = rng.get(BRIGHTNESS_FALLOFF_SPEED_MIN, BRIGHTNESS_FALLOFF_SPEED_MAX);
         brightnessInterval = rng.get(BRIGHTNESS_FALLOFF_INTERVAL_MIN, BRIGHTNESS_FALLOFF_INTERVAL_MAX);
@@ -249,7 +468,56 @@ void animateLEDs()
         brightnessFalloffValue = subtractByte(brightnessFalloffValue, brightnessSpeed, brightnessFalloffTarget);
     }
 #endif
-    updateLEDs();
+    requestLEDUpdate();
+}
+
+void seedAnimation(uint16_t seed)
+{
+    rng.setSeed(seed);
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+    byteDrifterBank.reset();
+#elif defined(ADVANCED_ANIMATION)
+    byteDrifter.reset();
+#else
+    brightnessFalloffValue = BRIGHTNESS_FALLOFF_MAX;
+    brightnessFalloffTarget = BRIGHTNESS_FALLOFF_MAX;
+    brightnessInterval = 0;
+    brightnessSpeed = BRIGHTNESS_FALLOFF_SPEED_MIN;
+#endif
+    requestLEDUpdate();
+}
+
+void saveAnimationState(byte *state)
+{
+    uint16_t seed = rng.getSeed();
+    state[0] = seed;
+    state[1] = seed >> 8;
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+    byteDrifterBank.serialize(state + 2);
+#elif defined(ADVANCED_ANIMATION)
+    byteDrifter.serialize(state + 2);
+#else
+    state[2] = brightnessFalloffValue;
+    state[3] = brightnessFalloffTarget;
+    state[4] = brightnessInterval;
+    state[5] = brightnessSpeed;
+#endif
+}
+
+void loadAnimationState(const byte *state)
+{
+    rng.setSeed(state[0] | ((uint16_t)state[1] << 8));
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+    byteDrifterBank.deserialize(state + 2);
+#elif defined(ADVANCED_ANIMATION)
+    byteDrifter.deserialize(state + 2);
+#else
+    brightnessFalloffValue = state[2];
+    brightnessFalloffTarget = state[3];
+    brightnessInterval = state[4];
+    brightnessSpeed = state[5];
+#endif
+    requestLEDUpdate();
 }
 #endif
 
@@ -262,6 +530,29 @@ void animateLEDs()
 // byte brightnessInterval = 0;
 // byte brightnessSpeed = 0;
 
+#ifdef TRACK_LED_STATS
+ledStats *getLEDStats()
+{
+    return &stats;
+}
+#endif
+
+#ifdef TRACK_INPUT_LATENCY
+void beginInputLatency(uint16_t edgeTime)
+{
+    if (!inputLatencyPending)
+    {
+        inputLatencyPending = true;
+        inputLatencyEdge = edgeTime;
+    }
+}
+
+inputLatencyStats *getInputLatency()
+{
+    return &inputLatency;
+}
+#endif
+
 byte getLEDBrightness()
 {
     return 255; // TEMP
@@ -281,7 +572,7 @@ void sleepLEDs()
 void wakeLEDs()
 {
     // queue an update to wake the LEDs so the strip is displayed again
-    queueUpdateLEDs = true;
+    requestLEDUpdate();
 }
 
 //
@@ -297,7 +588,7 @@ void clearLEDLocalData()
     //       Even tho the below is functionally identical, this does NOT break the build.
     clearLEDs = true;
     updateLEDs();
-#ifdef CALL_FASTLED_METHODS
+#if defined(CALL_FASTLED_METHODS) && !defined(LED_OUTPUT_USI)
     FastLED.clearData();
 #endif
 }
@@ -321,6 +612,6 @@ void saveLEDData()
     if (!savedLEDsThisSession)
     {
         savedLEDsThisSession = true;
-        updateLEDs();
+        requestLEDUpdate();
     }
 }
\ No newline at end of file
@@ -7,10 +7,11 @@
 #include "main.h"
 #include "pindef.h"
 #include "savedata.h"
+#include "profile.h"
 
 #define ENABLE_ANIMATION // allow animation rendering?
 
-#define LOOP_INTERVAL_LEDS 33 // how many ms in between loop() ticks for this class?
+#define LOOP_INTERVAL_LEDS 8 // how many ms in between loop() ticks for this class? (dispatched by scheduler.h, frame pacing resolution)
 
 #define CHIPSET WS2812B
 #define RGB_ORDER GRB
@@ -18,6 +19,17 @@
 // #define NUM_LEDS 12
 #define NUM_LEDS 11
 
+#define LED_FRAME_BUFFER_MAX_BYTES 96 // max SRAM the LED frame buffer may use. `leds` is the only frame buffer, no intermediate copies
+
+// #define LED_STREAM_PIXELS     // no frame buffer, generate each pixel just in time as it's output, so NUM_LEDS isn't limited by SRAM. Requires LED_OUTPUT_USI
+
+// index type for looping over LEDs, wide enough for NUM_LEDS
+#if NUM_LEDS > 255
+typedef uint16_t ledIndex;
+#else
+typedef byte ledIndex;
+#endif
+
 #define LED_MAX_BRIGHTNESS 64 // max brightness permitted by FastLED
 #define LED_MIN_BRIGHTNESS 10 // min brightness given via HSV values
 
@@ -26,17 +38,35 @@
 // #define LED_MAX_MILLIAMP_DRAW 250 // if defined, set max mA/H draw permitted by FastLED
 
 #define CALL_FASTLED_METHODS // call `FastLED.show` and other `FastLED.[thing]` methods? Used for debugging
+// #define LED_OUTPUT_USI       // output LED data via the USI peripheral instead of `FastLED.show`, holding off interrupts without losing any (see ledsUSI.h)
+#ifdef LED_OUTPUT_USI
+#include "ledsUSI.h"
+#ifdef LED_MAX_MILLIAMP_DRAW
+#error "LED_MAX_MILLIAMP_DRAW is applied by FastLED's output, it isn't supported with LED_OUTPUT_USI"
+#endif
+#endif
+
+// #define TRACK_LED_STATS        // count LED frames shown vs skipped (unchanged frames aren't pushed to the strip), see `getLEDStats`
+// #define TRACK_INPUT_LATENCY    // time each input from its pin edge to the strip output showing it, into a histogram, see `getInputLatency`
+#define INPUT_LATENCY_BUCKETS 8   // number of histogram buckets (uint16_t counts, 2 bytes SRAM each)
+#define INPUT_LATENCY_BUCKET_MS 8 // ms covered by each histogram bucket. The last bucket also counts everything longer
 
 #ifdef ENABLE_ANIMATION
 #define ADVANCED_ANIMATION // use ByteDrifter for animation?
 #include <Random16.h>
-#define ANIM_FPS 30 // Frames per second the animation will render at
+#define ANIM_FPS 30               // Frames per second (Hz) the animation will render at
+#define ANIM_MAX_CATCHUP_FRAMES 2 // max animation frames stepped in one loop() tick when running behind, before frames are dropped
+#define ANIM_FRAME_UNITS 1000     // one frame on the fixed timestep frame clock, in ms * ANIM_FPS (1000ms per second)
+#define ANIM_MAX_ELAPSED_MS ((ANIM_FRAME_UNITS * (ANIM_MAX_CATCHUP_FRAMES + 1)) / ANIM_FPS) // max ms the frame clock counts per tick
+// #define ANIMATION_REPLAY_SEED 1234 // if defined, seed animation with this instead of PIN_RANDOMSEED, so every boot replays the exact same frame sequence
 #ifdef ADVANCED_ANIMATION
+// #define LED_FLICKER_PER_PIXEL // give every LED its own independent flicker (ByteDrifterBank, 4 bytes SRAM per LED), instead of one ByteDrifter iterated down the strip
+#define LED_FLICKER_MAX_BYTES 48 // max SRAM LED_FLICKER_PER_PIXEL may use for its drifter bank
 #include "byteDrifter.h"
 #else
 #define BRIGHTNESS_FALLOFF_MIN 4
 #define BRIGHTNESS_FALLOFF_MAX 32
-#define BRIGHTNESS_CURVE_POWER 3
+#define BRIGHTNESS_CURVE_POWER 8 // exponent of the curve applied to random falloff targets (previously 3 repeated squarings, ie also x^8)
 #define BRIGHTNESS_FALLOFF_SPEED_MIN 2
 #define BRIGHTNESS_FALLOFF_SPEED_MAX 12
 #define BRIGHTNESS_FALLOFF_INTERVAL_MIN 10
@@ -47,11 +77,13 @@
 void setupLEDs();
 void loopLEDs();
 
-// shift the current LED colour by the given amount (HSV hue, 0 - 255, wrapping)
+// shift the current LED colour by the given amount (HSV hue, 0 - 255, wrapping), displayed on the next frame
 void shiftLEDColor(byte delta);
-// shift the current LED brightness by the given amount (HSV value, LED_MIN_BRIGHTNESS - 255, clamped)
-void shiftLEDBrightness(byte delta);
-// output the current colour information to FastLED
+// shift the current LED brightness by the given signed amount (HSV value, LED_MIN_BRIGHTNESS - 255, clamped), displayed on the next frame
+void shiftLEDBrightness(int delta);
+// request `updateLEDs` on the next `loopLEDs` frame. Any number of requests per frame result in a single update
+void requestLEDUpdate();
+// output the current colour information to FastLED immediately. Prefer `requestLEDUpdate` outside of leds.cpp
 void updateLEDs();
 
 // debug convenience function to shift LED colour by 128 (opposite end of the spectrum from current)
@@ -62,9 +94,54 @@ void testLEDColor();
 // return a byte for the LED's current HSV brightness value (V)
 byte getLEDBrightness();
 
+#ifdef TRACK_LED_STATS
+// container for LED output counters (wrapping), for debugging and profiling
+struct ledStats
+{
+    uint16_t showsIssued = 0;  // frames pushed to the strip via `FastLED.show`
+    uint16_t showsSkipped = 0; // frames NOT pushed, because they were identical to the last frame shown
+#ifdef ENABLE_ANIMATION
+    uint16_t framesRendered = 0;   // frame boundaries reached by the frame clock
+    uint16_t framesDropped = 0;    // frames due but never rendered, because the frame clock was running behind (including past ANIM_MAX_ELAPSED_MS)
+    uint16_t worstFrameMicros = 0; // longest time taken to step and render one frame (including `FastLED.show`), in microseconds
+#endif
+};
+// returns the LED output counters
+ledStats *getLEDStats();
+#endif
+
+#ifdef TRACK_INPUT_LATENCY
+// histogram of input latency, from an input's pin edge (timestamped in its interrupt) to the end of the strip output showing it
+struct inputLatencyStats
+{
+    uint16_t counts[INPUT_LATENCY_BUCKETS] = {}; // inputs per latency, bucket `i` is `i * INPUT_LATENCY_BUCKET_MS` ms and up (saturating)
+    uint16_t worstMillis = 0;                     // longest latency recorded, in ms
+};
+// Start timing an input that changes the LEDs, from scheduler tick `edgeTime` (see `inputEvent`).
+// If an earlier input is still waiting to be shown, it's kept instead (both are shown by the same frame)
+void beginInputLatency(uint16_t edgeTime);
+// returns the input latency histogram
+inputLatencyStats *getInputLatency();
+#endif
+
 #ifdef ENABLE_ANIMATION
-// process one frame of LED animation
+// process one frame of LED animation (and request it be displayed)
 void animateLEDs();
+
+// size in bytes of the animation state written by `saveAnimationState` (RNG seed + animation values)
+#if defined(ADVANCED_ANIMATION) && defined(LED_FLICKER_PER_PIXEL)
+#define ANIM_STATE_BYTES (2 + ByteDrifterBank<NUM_LEDS>::stateSize)
+#elif defined(ADVANCED_ANIMATION)
+#define ANIM_STATE_BYTES (2 + ByteDrifter<>::stateSize)
+#else
+#define ANIM_STATE_BYTES (2 + 4)
+#endif
+// reseed and restart animation, every frame after this depends only on `seed` (see ANIMATION_REPLAY_SEED)
+void seedAnimation(uint16_t seed);
+// write the full animation state into `state`, ANIM_STATE_BYTES long, for debugging or replay
+void saveAnimationState(byte *state);
+// restore animation state written by `saveAnimationState`, the following frames replay exactly as they did after the save
+void loadAnimationState(const byte *state);
 #endif
 
 // call from sleep.h when device is put to sleep (to disable LED display)
@@ -79,4 +156,64 @@ void loadLEDData();
 // save LED colour data to EEPROM
 void saveLEDData();
 
+#ifdef ENABLE_ANIMATION
+// error checks for frame pacing
+#if ANIM_FPS < 1 || ANIM_FPS > 250
+#error "ANIM_FPS must be between 1 and 250 Hz"
+#endif
+#if LOOP_INTERVAL_LEDS * ANIM_FPS > ANIM_FRAME_UNITS
+#error "LOOP_INTERVAL_LEDS is longer than one animation frame, frames would be dropped constantly. Lower it below 1000 / ANIM_FPS"
+#endif
+#if ANIM_MAX_CATCHUP_FRAMES < 1
+#error "ANIM_MAX_CATCHUP_FRAMES must be at least 1"
+#endif
+#if defined(LED_FLICKER_PER_PIXEL) && NUM_LEDS * 4 > LED_FLICKER_MAX_BYTES
+#error "NUM_LEDS drifter bank exceeds LED_FLICKER_MAX_BYTES, there isn't enough SRAM for per-pixel flicker"
+#endif
+#endif
+
+#ifdef LED_STREAM_PIXELS
+// error checks for pixel streaming
+#ifndef LED_OUTPUT_USI
+#error "LED_STREAM_PIXELS requires LED_OUTPUT_USI, FastLED's output needs a frame buffer"
+#endif
+// low gap each streamed pixel's generation adds (beyond the USI byte it overlaps, see `streamLEDsUSI`), in us.
+// Hand-counted at 8MHz, NOT yet measured in a simulator (trace PA5 as per ledsUSI.h to confirm)
+#if !defined(ENABLE_ANIMATION) || (defined(ADVANCED_ANIMATION) && !defined(LED_FLICKER_PER_PIXEL) && !defined(DECAY_ENABLED))
+#define LED_STREAM_SHARED_BRIGHTNESS // every pixel in a frame has the same brightness, so it's dimmed once per frame (see `beginFrame`)
+#define LED_STREAM_GAP_US 5          // ~26-34 cycles: generator call, copy the pre-dimmed colour, first USI pattern, held tick poll
+#else
+#define LED_STREAM_GAP_US 30 // ~200 cycles: per pixel brightness is dimmed per pixel, four software 8x8 multiplies (no MUL on the ATtiny)
+#endif
+#if LED_STREAM_GAP_US > WS2812_USI_GAP_MAX_US
+#error "Per-pixel brightness (LED_FLICKER_PER_PIXEL, DECAY_ENABLED, or basic animation) is too slow to generate between streamed pixels, see WS2812_USI_GAP_MAX_US. Use a frame buffer (no LED_STREAM_PIXELS) instead"
+#endif
+// time in us to generate AND output one streamed pixel
+#define LED_STREAM_PIXEL_US (WS2812_USI_PIXEL_US + LED_STREAM_GAP_US)
+// streaming a frame must fit in half of one frame period, leaving the rest for everything else
+#ifdef ENABLE_ANIMATION
+#define LED_STREAM_FRAME_BUDGET_US (500000L / ANIM_FPS)
+#else
+#define LED_STREAM_FRAME_BUDGET_US (500L * LOOP_INTERVAL_LEDS)
+#endif
+#if NUM_LEDS * LED_STREAM_PIXEL_US > LED_STREAM_FRAME_BUDGET_US
+#error "NUM_LEDS is too long to stream within half a frame period, lower NUM_LEDS or ANIM_FPS"
+#endif
+#if NUM_LEDS > 65535
+#error "NUM_LEDS must fit in a 16bit index"
+#endif
+#else
+// error check for frame buffer size (3 bytes per CRGB pixel)
+#if NUM_LEDS * 3 > LED_FRAME_BUFFER_MAX_BYTES
+#error "NUM_LEDS frame buffer exceeds LED_FRAME_BUFFER_MAX_BYTES, there isn't enough SRAM for it (use LED_STREAM_PIXELS for longer strips)"
+#endif
+#endif
+
+#ifdef TRACK_INPUT_LATENCY
+// error check for histogram size
+#if INPUT_LATENCY_BUCKETS < 1 || INPUT_LATENCY_BUCKET_MS < 1
+#error "INPUT_LATENCY_BUCKETS and INPUT_LATENCY_BUCKET_MS must both be at least 1"
+#endif
+#endif
+
 #endif // LEDS_H
\ No newline at end of file
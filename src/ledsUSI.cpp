@@ -0,0 +1,161 @@
+#include "ledsUSI.h"
+
+#include "scheduler.h"
+
+// USI status value that clears the overflow flag and preloads the 4bit counter to overflow after 8 shifts
+#define USI_STATUS_8_SHIFTS ((1 << USIOIF) | (16 - 8))
+
+void setupLEDsUSI()
+{
+    // DO idles low
+    PORTA &= ~(1 << PORTA_BIT_LED_DATA);
+    DDRA |= (1 << PORTA_BIT_LED_DATA);
+}
+
+// Wait for the previous USI byte to finish shifting, then start shifting `pattern`
+static inline void usiWrite(byte pattern)
+{
+    while (!(USISR & (1 << USIOIF)))
+    {
+        // previous byte still shifting (DO is low once it's done)
+    }
+    // restart the sub-bit period as the byte is written, so its first sub-bit is a full period.
+    // the counter is set one timer clock back (0xFF) to cover the cycle between the two writes.
+    // atomic, as an interrupt between these writes could stretch a high sub-bit (turning a 0 into a 1)
+    byte sreg = SREG;
+    cli();
+    TCNT0 = 0xFF;
+    USIDR = pattern;
+    USISR = USI_STATUS_8_SHIFTS;
+    SREG = sreg;
+}
+
+// Send one WS2812 byte, MSB first, as 4 USI bytes of 2 WS2812 bits each
+static inline void usiSendByte(byte value)
+{
+    for (byte i = 0; i < 4; i++)
+    {
+        // 0x88 = 1000 1000, top bit of each nibble is always high, second bit high for a WS2812 1
+        byte pattern = 0x88;
+        if (value & 0x80)
+        {
+            pattern |= 0x40;
+        }
+        if (value & 0x40)
+        {
+            pattern |= 0x04;
+        }
+        value <<= 2;
+        usiWrite(pattern);
+    }
+}
+
+// Timer0 config, preserved while it's borrowed from millis to clock the USI
+static byte timerControlA;
+static byte timerControlB;
+static byte timerCompare;
+static byte timerInterrupts;
+// interrupt enables masked during output, see ledsUSI.h
+static byte tickInterrupts;
+static byte pinInterrupts;
+static byte heldTicks; // scheduler ticks that fell due during output, see `holdTick`
+
+// borrow Timer0 and start the USI, ready for the first `usiSendByte`
+static void beginUSIOutput()
+{
+    // borrow Timer0 (from millis), preserving its config
+    timerControlA = TCCR0A;
+    timerControlB = TCCR0B;
+    timerCompare = OCR0A;
+    timerInterrupts = TIMSK0;
+    TIMSK0 = 0;
+    TCCR0B = 0;
+
+    // mask the interrupts that could run mid-frame, leaving their flags pending for once output ends
+    tickInterrupts = TIMSK1;
+    TIMSK1 &= ~(1 << OCIE1A);
+    pinInterrupts = GIMSK;
+    GIMSK &= ~(1 << PCIE1);
+    heldTicks = 0;
+    TCCR0A = (1 << WGM01); // CTC, TOP = OCR0A
+    OCR0A = WS2812_USI_TIMER_TOP;
+    TCNT0 = 0;
+
+    // DI low, so DO reads low between USI bytes
+    PORTA &= ~(1 << PA6);
+    DDRA |= (1 << PA6);
+
+    // three-wire mode, shifted by Timer0 compare match. prime with one zero shift so
+    // the overflow flag is set by the time the first real byte is written
+    USIDR = 0;
+    USISR = (1 << USIOIF) | (16 - 1);
+    USICR = (1 << USIWM0) | (1 << USICS0);
+    TCCR0B = (1 << CS00); // start Timer0, no prescaler
+}
+
+// count a scheduler tick that fell due while its interrupt is masked. Polled once per pixel (~36us),
+// well within a tick, so none are missed. ~3 cycles, while the pixel's last USI byte shifts out
+static inline void holdTick()
+{
+    if (TIFR1 & (1 << OCF1A))
+    {
+        TIFR1 = (1 << OCF1A);
+        heldTicks++;
+    }
+}
+
+// send one pixel, GRB order, as is (already scaled, no multiplies between USI bytes)
+static inline void usiSendPixel(CRGB pixel)
+{
+    usiSendByte(pixel.g);
+    usiSendByte(pixel.r);
+    usiSendByte(pixel.b);
+    holdTick();
+}
+
+// wait for the final byte, then release the USI and Timer0
+static void endUSIOutput()
+{
+    while (!(USISR & (1 << USIOIF)))
+    {
+    }
+    // release USI (DO falls back to PORTA, low), DI, and Timer0
+    USICR = 0;
+    DDRA &= ~(1 << PA6);
+    TCCR0B = 0;
+    TCCR0A = timerControlA;
+    OCR0A = timerCompare;
+    TIFR0 = (1 << OCF0A) | (1 << TOV0); // clear flags raised while borrowed
+    TIMSK0 = timerInterrupts;
+    TCCR0B = timerControlB;
+    // credit the ticks held during output, and unmask (a tick or encoder edge still pending is serviced now)
+    if (heldTicks != 0)
+    {
+        addSchedulerTicks(heldTicks);
+    }
+    GIMSK = pinInterrupts;
+    TIMSK1 = tickInterrupts;
+    // the strip latches once DO has been low for its reset time, well before the next frame
+}
+
+void showLEDsUSI(const CRGB *pixels, uint16_t count)
+{
+    beginUSIOutput();
+    for (uint16_t i = 0; i < count; i++)
+    {
+        usiSendPixel(pixels[i]);
+    }
+    endUSIOutput();
+}
+
+void streamLEDsUSI(ledPixelGenerator generator, uint16_t count)
+{
+    beginUSIOutput();
+    for (uint16_t i = 0; i < count; i++)
+    {
+        // `usiWrite` returns as soon as a byte starts shifting, so each pixel is generated
+        // while the last USI byte of the previous pixel is still going out
+        usiSendPixel(generator(i));
+    }
+    endUSIOutput();
+}
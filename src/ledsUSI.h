@@ -0,0 +1,72 @@
+#ifndef LEDSUSI_H
+#define LEDSUSI_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "pindef.h"
+
+// WS2812 output driver using the ATtiny84's USI in three-wire mode, clocked by Timer0
+// compare match, so bits are shifted out of DO by hardware. The CPU only refills one
+// byte of USI data every (8 * (WS2812_USI_TIMER_TOP + 1)) cycles. Select it with
+// LED_OUTPUT_USI in leds.h.
+//
+// Each WS2812 bit is sent as 4 USI sub-bits, 0 = 1000, 1 = 1100, so each USI byte
+// carries 2 WS2812 bits and always ends low. At 8MHz with TOP = 2, one sub-bit is
+// 3 cycles (375ns), giving T0H = 375ns, T1H = 750ns, and 1.5us per bit. Between USI
+// bytes DO idles low, which stretches the low time of the previous bit.
+//
+// That stretch must stay under WS2812_USI_GAP_MAX_US. The datasheet's reset time (>= 50us,
+// >= 280us on newer WS2812B) is only how long a low is guaranteed to latch, not how short
+// a low is guaranteed NOT to: some parts latch after well under 10us low, mid-frame,
+// cutting the strip short. So the interrupts that could run mid-frame (the scheduler tick
+// and encoder pin change, ~10-25us each) are masked for the frame, rather than disabling
+// all interrupts as FastLED's driver does. Their flags stay pending, so each is serviced
+// once output ends, and scheduler ticks that fall due meanwhile are counted and credited
+// (see `addSchedulerTicks`), so no time is lost on long (streamed) strips. The encoder
+// only sees its pins' latest state once output ends, and the switch misses those samples.
+//
+// To verify in an AVR simulator (eg simavr), trace PA5 (DO): every high pulse must be
+// 375ns or 750ns (one or two sub-bits), and no low gap may exceed WS2812_USI_GAP_MAX_US mid-frame.
+//
+// Expected timing, hand-counted from the code (NOT yet measured in a simulator):
+//  - high: 375ns / 750ns exactly, set by the USI alone (each byte refill is atomic)
+//  - low between USI bytes: ~0.6-1us added to the previous bit's low time, the refill
+//    itself (flag poll exit, `cli`, three register writes). The next byte's pattern is
+//    built while the previous one shifts (~10 of its 24 cycles), and pixels arrive
+//    already scaled to the output brightness, so no multiply runs between bytes
+//  - low between pixels: the above, plus ~3 cycles polling for a held tick (~8 when one is held, once per ms)
+//
+// NOTE: while shifting, Timer0 is borrowed from `millis`/`micros` (they pause, much
+// like FastLED's driver), and is restored afterwards. Timer1 (scheduler.h) keeps counting, only its interrupt is masked.
+// NOTE: DI (PA6) is driven low during output, as DO idles at DI's level once a USI byte
+// has been fully shifted out, so PA6 must be left unconnected.
+// NOTE: output is GRB order (WS2812B), and pixels are sent as given. There's no `FastLED.setBrightness`,
+// so apply the max brightness while rendering (eg once per frame to a shared colour, see `beginFrame` in leds.cpp)
+
+#define WS2812_USI_TIMER_TOP 2  // Timer0 compare value, one USI sub-bit per (TOP + 1) CPU cycles, tuned for 8MHz
+#define WS2812_USI_GAP_MAX_US 5 // max low time (us) any mid-frame gap may add to a bit, the commonly used safe limit, below any part's latch
+
+// prep the USI data out pin, call once in setup
+void setupLEDsUSI();
+#define WS2812_USI_PIXEL_US 36 // time in us to shift out one pixel (24 bits * 4 sub-bits * 375ns), excluding gaps
+
+// Returns the colour of pixel `index`, called for every index in order, just in time for output
+typedef CRGB (*ledPixelGenerator)(uint16_t index);
+
+// stream `count` pixels out through the USI
+void showLEDsUSI(const CRGB *pixels, uint16_t count);
+// stream `count` pixels out through the USI as they're returned by `generator`.
+// Needs no frame buffer, but `generator` must return within a few us (each pixel's generation time,
+// minus one USI byte of 24 cycles, is added as low time to the previous pixel's last bit, see LED_STREAM_GAP_US in leds.h)
+void streamLEDsUSI(ledPixelGenerator generator, uint16_t count);
+
+// error checks for USI output
+#if PORTA_BIT_LED_DATA != PA5
+#error "USI LED output requires PIN_LED_DATA on the USI data out pin (DO, PA5)"
+#endif
+#if F_CPU != 8000000L
+#error "WS2812_USI_TIMER_TOP sub-bit timing is tuned for an 8MHz clock, retune it for this F_CPU"
+#endif
+
+#endif // LEDSUSI_H
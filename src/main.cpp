@@ -10,6 +10,10 @@ void setup()
     setupSleep();
     setupInput();
     setupLEDs(); // setup LEDs last (after Input)
+#if defined(ENABLE_PROFILING) && defined(PROFILE_BYTEMATH_KERNELS)
+    profileByteMathKernels(); // before the tick timer starts, see profile.h
+#endif
+    setupScheduler(); // start tick timer once everything else is ready
 
     // FastLED.setBrightness(64);
     // FastLED.addLeds<WS2812B, 5, GRB>(ledsTest, NUM_LEDS_TEST);
@@ -37,12 +41,6 @@ void loop()
     //     FastLED.show();
     // }
 
-    loopInput();
-    loopLEDs();
-    loopSaveData();
-    loopSleep();
-
-    // loop interval
-    // FastLED.delay(DELAY_INTERVAL);
-    delay(DELAY_INTERVAL);
+    // dispatch class loops at their own intervals, idling in between ticks
+    loopScheduler();
 }
\ No newline at end of file
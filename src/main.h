@@ -3,11 +3,10 @@
 
 #include <Arduino.h>
 
-#define DELAY_INTERVAL 10 // delay in ms per loop() cycle
-
 #include "leds.h"
 #include "input.h"
 #include "sleep.h"
 #include "savedata.h"
+#include "scheduler.h" // include scheduler last (dispatches all of the above)
 
 #endif // MAIN_H
\ No newline at end of file
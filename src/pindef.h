@@ -2,11 +2,17 @@
 #define PINDEF_H
 
 #define PIN_LED_DATA 5 // pin for LEDs, must be `PWM`
+#define PORTA_BIT_LED_DATA PA5 // Port A bit number of PIN_LED_DATA (PA5, pin 5, also USI `DO`, see ledsUSI.h)
 
 #define PIN_ENC_CLK 9    // pin for encoder `CLK` signal, must be on Port B
 #define PIN_ENC_DAT 10   // pin for encoder `DAT` signal, must be on Port B
 #define PIN_ENC_SWITCH 8 // pin for encoder switch, must be on external interrupt (pin 8, INT0, Port B)
 
+// Port B bit numbers of the above encoder pins, for reading all of them in a single PINB read
+#define PORTB_BIT_ENC_DAT PB0    // PB0, pin 10
+#define PORTB_BIT_ENC_CLK PB1    // PB1, pin 9
+#define PORTB_BIT_ENC_SWITCH PB2 // PB2, pin 8
+
 #define PIN_RANDOMSEED A7 // pin for `randomSeed` sampling, must be an unconnected analog pin
 
 // TODO: External clock on X1/X2. Either move pins back onto Ports A/B cross, or move switch off of INTO (PB) and all pins onto Port A
@@ -0,0 +1,63 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+
+// #define ENABLE_PROFILING // write profile markers to GPIOR0 around hot paths, for cycle counting under simavr (see [env:profile], tools/profile.py)
+// #define PROFILE_BYTEMATH_KERNELS // also time the byteMath kernels over a sweep of inputs, once at startup (see [env:profile_kernels], profileByteMathKernels)
+
+// profile marker IDs, written to GPIOR0 on entry, and with PROFILE_EXIT set on exit.
+// tools/profile.py reads the names from here, so keep them as `PROFILE_[NAME] [id]`
+#define PROFILE_LOOP_INPUT 1    // `loopInput`
+#define PROFILE_ANIMATE_LEDS 2  // `animateLEDs`
+#define PROFILE_DRIFTER_TICK 3  // `ByteDrifter::tick` (or `ByteDrifterBank::tick`), within `animateLEDs`
+#define PROFILE_UPDATE_LEDS 4   // `updateLEDs`, render and output
+#define PROFILE_LED_OUTPUT 5    // strip output within `updateLEDs`. Interrupts are disabled for all of it (LED_OUTPUT_USI: only the tick and encoder interrupts are masked)
+#define PROFILE_KERNEL_ADD_BYTE 6     // one `addByte(byte, int)` call, PROFILE_BYTEMATH_KERNELS only. Each kernel window includes a volatile load and store, ~4 cycles
+#define PROFILE_KERNEL_LERP_Q16 7     // one `lerpByteQ16` call, PROFILE_BYTEMATH_KERNELS only
+#define PROFILE_KERNEL_CURVE_Q16 8    // one `curvedLerpByteQ16` call (default cubic curve), PROFILE_BYTEMATH_KERNELS only
+#define PROFILE_KERNEL_LERP_FLOAT 9   // one float `lerpByte` call, PROFILE_BYTEMATH_KERNELS with BYTEMATH_FLOAT_FUNCTIONS only
+#define PROFILE_KERNEL_CURVE_FLOAT 10 // one float `curvedLerpByte` call (default cubic curve), as above
+
+// interrupts-disabled windows, IDs with PROFILE_IRQ_OFF set (reported separately by tools/profile.py).
+// Markers sit just inside each window, so add a few cycles by hand: ~3 for an ATOMIC_BLOCK's SREG save/`cli`/restore,
+// and for interrupts, the vector jump, register saves/restores and `reti` (~20-40 cycles, see the disassembly)
+#define PROFILE_ENCODER_ISR 0x41     // encoder pin change interrupt body (see input.cpp)
+#define PROFILE_TICK_ISR 0x42        // scheduler tick interrupt body, including encoder switch sampling (see scheduler.cpp)
+#define PROFILE_SWITCH_ISR 0x43      // encoder switch wake interrupt body (see input.cpp)
+#define PROFILE_IDLE_CHECK 0x44      // scheduler's `cli` tick check before idling, up to `sei`
+#define PROFILE_SCHEDULER_TICKS 0x45 // `getSchedulerTicks` atomic read (also runs nested inside interrupts)
+#define PROFILE_ENCODER_READ 0x46    // `readEncoderDelta` atomic block
+#define PROFILE_ENCODER_POLL 0x47    // POLL_ENCODER_LOOP atomic `tickEncoder` in `loopInput`
+#define PROFILE_SWITCH_RESET 0x48    // `resetEncoderSwitch` atomic block
+#define PROFILE_IRQ_OFF 0x40         // marker bit for interrupts-disabled windows
+#define PROFILE_EXIT 0x80            // marker bit for exit
+
+#ifdef ENABLE_PROFILING
+// one `out` instruction each (1 cycle), so markers barely disturb what they measure
+#define PROFILE_BEGIN(id) (GPIOR0 = (id))
+#define PROFILE_END(id) (GPIOR0 = (id) | PROFILE_EXIT)
+#else
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#endif
+
+#if defined(ENABLE_PROFILING) && defined(PROFILE_BYTEMATH_KERNELS)
+// Times each byteMath kernel once per input byte, so tools/profile.py reports min/mean/max per kernel.
+// Call before the scheduler starts, so no interrupts land inside the windows
+void profileByteMathKernels();
+#endif
+
+// NOT marked: `usiWrite`'s `cli` (ledsUSI.cpp, three register writes, ~5 cycles per USI byte, where a marker
+// would disturb the output timing), and FastLED's own `show` (covered by PROFILE_LED_OUTPUT above).
+// The input queue has no atomic blocks, it's lock-free (see inputQueue.h)
+
+// error checks for defined values
+#if defined(ENABLE_PROFILING) && !defined(GPIOR0)
+#error "ENABLE_PROFILING writes markers to GPIOR0, which this MCU doesn't have"
+#endif
+#if defined(PROFILE_BYTEMATH_KERNELS) && !defined(ENABLE_PROFILING)
+#error "PROFILE_BYTEMATH_KERNELS needs ENABLE_PROFILING, see [env:profile_kernels]"
+#endif
+
+#endif // PROFILE_H
@@ -9,8 +9,7 @@
 
 #define ENABLE_SAVEDATA // Use SaveData? SaveData should be setup first and looped last
 
-#define LOOP_INTERVAL_SAVEDATA 232 // how many ms in between loop() ticks for this class?
-// note: loop intervals should not be greater than 255 - (DELAY_INTERVAL * 2)
+#define LOOP_INTERVAL_SAVEDATA 232 // how many ms in between loop() ticks for this class? (dispatched by scheduler.h)
 
 #define DATA_DEFAULT_LED_HUE 213 // default HSV hue (H) for LED colour 
 #define DATA_DEFAULT_LED_VALUE 255 // default HSV value (V) for LED colour (brightness)
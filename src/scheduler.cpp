@@ -0,0 +1,151 @@
+#include "scheduler.h"
+
+#include <util/atomic.h>
+
+// dispatch intervals for each class, or every tick if the class has no (valid) loop interval
+// (resolved here rather than scheduler.h, so every class header has been fully included first)
+#if defined(LOOP_INTERVAL_INPUT) && LOOP_INTERVAL_INPUT > 1
+#define SCHEDULE_INTERVAL_INPUT LOOP_INTERVAL_INPUT
+#else
+#define SCHEDULE_INTERVAL_INPUT SCHEDULER_TICK_MS
+#endif
+#if defined(LOOP_INTERVAL_LEDS) && LOOP_INTERVAL_LEDS > 1
+#define SCHEDULE_INTERVAL_LEDS LOOP_INTERVAL_LEDS
+#else
+#define SCHEDULE_INTERVAL_LEDS SCHEDULER_TICK_MS
+#endif
+#if defined(LOOP_INTERVAL_SAVEDATA) && LOOP_INTERVAL_SAVEDATA > 1
+#define SCHEDULE_INTERVAL_SAVEDATA LOOP_INTERVAL_SAVEDATA
+#else
+#define SCHEDULE_INTERVAL_SAVEDATA SCHEDULER_TICK_MS
+#endif
+#if defined(LOOP_INTERVAL_SLEEP) && LOOP_INTERVAL_SLEEP > 1
+#define SCHEDULE_INTERVAL_SLEEP LOOP_INTERVAL_SLEEP
+#else
+#define SCHEDULE_INTERVAL_SLEEP SCHEDULER_TICK_MS
+#endif
+
+#if SCHEDULE_INTERVAL_INPUT > 0x7FFF || SCHEDULE_INTERVAL_LEDS > 0x7FFF || SCHEDULE_INTERVAL_SAVEDATA > 0x7FFF || SCHEDULE_INTERVAL_SLEEP > 0x7FFF
+#error "Loop intervals must be less than 32768ms, as they're compared against the 16bit wrapping scheduler tick count"
+#endif
+
+static volatile uint16_t schedulerTicks = 0; // ms ticks counted by the Timer1 compare interrupt
+
+// tick count at which each class is next due to be dispatched
+static uint16_t nextTickInput = 0;
+static uint16_t nextTickLEDs = 0;
+static uint16_t nextTickSaveData = 0;
+static uint16_t nextTickSleep = 0;
+
+//
+// ------------------------------------------------------------ [  SETUP AND LOOP  ] ---------
+//
+
+void setupScheduler()
+{
+    // Timer1 in CTC mode, cleared on OCR1A compare match, /64 prescaler, no output pins
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCCR1A = 0;
+        TCCR1B = (1 << WGM12) | (1 << CS11) | (1 << CS10);
+        TCNT1 = 0;
+        OCR1A = SCHEDULER_TIMER_TOP;
+        TIMSK1 |= (1 << OCIE1A);
+        schedulerTicks = 0;
+    }
+}
+
+// Returns true if the given task is due at tick `now`, and advances its deadline.
+// Deadlines advance by a fixed interval (rather than from `now`), so time spent
+// doing work doesn't accumulate as drift. If a task falls a whole interval or more
+// behind (eg, a long `FastLED.show()`), it's resynced instead of dispatched in a burst.
+static bool taskDue(uint16_t now, uint16_t &nextTick, uint16_t interval)
+{
+    if ((int16_t)(now - nextTick) < 0)
+    {
+        return false; // not due yet
+    }
+    nextTick += interval;
+    if ((int16_t)(now - nextTick) >= 0)
+    {
+        nextTick = now + interval; // too far behind, resync
+    }
+    return true;
+}
+
+void loopScheduler()
+{
+    uint16_t now = getSchedulerTicks();
+
+    // dispatch classes in their original order (savedata looped last, see savedata.h)
+    if (taskDue(now, nextTickInput, SCHEDULE_INTERVAL_INPUT))
+    {
+        PROFILE_BEGIN(PROFILE_LOOP_INPUT);
+        loopInput();
+        PROFILE_END(PROFILE_LOOP_INPUT);
+    }
+    if (taskDue(now, nextTickLEDs, SCHEDULE_INTERVAL_LEDS))
+    {
+        loopLEDs();
+    }
+    if (taskDue(now, nextTickSaveData, SCHEDULE_INTERVAL_SAVEDATA))
+    {
+        loopSaveData();
+    }
+    if (taskDue(now, nextTickSleep, SCHEDULE_INTERVAL_SLEEP))
+    {
+        loopSleep();
+    }
+
+    // idle until the next interrupt, unless a tick already arrived while dispatching.
+    // the tick check and `sleep_cpu` are atomic: `sei` always executes the following
+    // instruction before servicing any pending interrupt, so a tick can't slip in between
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    PROFILE_BEGIN(PROFILE_IDLE_CHECK);
+    if (schedulerTicks == now)
+    {
+        sleep_enable();
+        PROFILE_END(PROFILE_IDLE_CHECK);
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    PROFILE_END(PROFILE_IDLE_CHECK); // (already ended if idled, a repeat exit is ignored)
+    sei();
+}
+
+uint16_t getSchedulerTicks()
+{
+    uint16_t ticks;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        PROFILE_BEGIN(PROFILE_SCHEDULER_TICKS);
+        ticks = schedulerTicks;
+        PROFILE_END(PROFILE_SCHEDULER_TICKS);
+    }
+    return ticks;
+}
+
+void addSchedulerTicks(byte ticks)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        schedulerTicks += (uint16_t)ticks * SCHEDULER_TICK_MS;
+    }
+}
+
+//
+// ------------------------------------------------------------ [  INTERRUPTS  ] ---------
+//
+
+ISR(TIM1_COMPA_vect)
+{
+    PROFILE_BEGIN(PROFILE_TICK_ISR);
+    schedulerTicks += SCHEDULER_TICK_MS;
+#if defined(ENABLE_INPUT) && defined(USE_ENCODER_SWITCH_LOGIC)
+    // sample the encoder switch once per tick, for a fixed debounce time (see encoderSwitch.h)
+    tickEncoderSwitch();
+#endif
+    PROFILE_END(PROFILE_TICK_ISR);
+}
@@ -0,0 +1,34 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+#include "main.h"
+#include "profile.h"
+
+#define SCHEDULER_TICK_MS 1          // how many ms per scheduler timer tick?
+#define SCHEDULER_TIMER_PRESCALER 64 // Timer1 clock prescaler (must match the CS1x bits set in setupScheduler)
+
+// Timer1 compare value for one tick, eg 8MHz / 64 / 1000 - 1 = 124
+#define SCHEDULER_TIMER_TOP ((F_CPU / SCHEDULER_TIMER_PRESCALER / 1000UL * SCHEDULER_TICK_MS) - 1)
+
+void setupScheduler();
+// dispatch every class whose loop interval has elapsed, then idle the CPU until the next interrupt
+void loopScheduler();
+
+// Returns the number of ms elapsed since `setupScheduler`, as counted by the tick timer.
+// Wraps every ~65 seconds, so only compare via subtraction, eg `(uint16_t)(now - then)`.
+//
+// NOTE: the tick timer stops in power-down sleep, so time spent asleep is not counted.
+uint16_t getSchedulerTicks();
+// Count `ticks` ticks that fell due while the tick interrupt was masked, eg during strip output (see ledsUSI.h).
+// Only the time is counted, the encoder switch misses those samples (delaying its debounce)
+void addSchedulerTicks(byte ticks);
+
+// error checks for defined values
+#if SCHEDULER_TIMER_TOP > 0xFFFF || SCHEDULER_TIMER_TOP < 1
+#error "SCHEDULER_TIMER_TOP doesn't fit in Timer1's 16bit compare register, adjust SCHEDULER_TICK_MS or SCHEDULER_TIMER_PRESCALER"
+#endif
+
+#endif // SCHEDULER_H
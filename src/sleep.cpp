@@ -2,8 +2,6 @@
 
 #ifdef USE_SLEEP_TIMER
 
-static int _loopIntervalSleep = 0; // timer to keep track of loop() intervals for this class
-
 byte secondsIdle = 0;
 byte minutesIdle = 0;
 
@@ -12,8 +10,8 @@ byte minutesIdle = 0;
 void setupSleep()
 {
 #ifdef ENABLE_SLEEP
-    // prep correct sleep mode
-    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    // nothing to prep here: scheduler.h idles in SLEEP_MODE_IDLE between ticks,
+    // so power-down sleep mode is selected in goToSleep instead
 // info on sleep modes: https://onlinedocs.microchip.com/oxy/GUID-A834D554-5741-41A3-B5E1-35ED7CD8250A-en-US-5/GUID-35CAFA19-CA93-4B3E-AEE3-481B8542FE94.html
 #endif
 }
@@ -21,21 +19,7 @@ void setupSleep()
 void loopSleep()
 {
 #ifdef USE_SLEEP_TIMER
-    // check savedata loop delay
-// #if defined(LOOP_INTERVAL_SLEEP) && LOOP_INTERVAL_SLEEP > 1
-    _loopIntervalSleep += DELAY_INTERVAL;
-    if (_loopIntervalSleep >= LOOP_INTERVAL_SLEEP)
-    {
-        _loopIntervalSleep -= LOOP_INTERVAL_SLEEP;
-    }
-    else
-    {
-        return;
-    }
-// #else
-// #error "LOOP_INTERVAL_SLEEP is not used, it should be set to 1000, as it's used to check how many ms are in one second"
-// #endif
-    // passed initial loop check, increment seconds and minutes as needed
+    // scheduler.h dispatches this once every LOOP_INTERVAL_SLEEP (one second), increment seconds and minutes as needed
     // one loop passed
     // loopsIdle++;
     // if (loopsIdle < LOOPS_PER_SECOND)
@@ -81,10 +65,11 @@ void goToSleep()
     sleepLEDs();  // put LED display to sleep
 
     // 2) Prep device for sleep mode
-    resetSleepTimer();   // reset sleep timing values
-    sleep_enable();      // enable sleep bit
-    sleep_bod_disable(); // disable brownout detection
-    sei();               // ensure interrupts are active
+    resetSleepTimer();                   // reset sleep timing values
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN); // power-down mode (scheduler re-selects idle mode for its next idle)
+    sleep_enable();                      // enable sleep bit
+    sleep_bod_disable();                 // disable brownout detection
+    sei();                               // ensure interrupts are active
 
     // 3) put device to sleep
     sleep_cpu(); // begin sleep mode
@@ -10,7 +10,7 @@
 
 #ifdef ENABLE_SLEEP
 
-#define LOOP_INTERVAL_SLEEP 1000 // how many ms in between loop() ticks for this class?
+#define LOOP_INTERVAL_SLEEP 1000 // how many ms in between loop() ticks for this class? (dispatched by scheduler.h, must be one second)
 
 #define USE_SLEEP_TIMER // will the device automatically sleep after a certain time without interaction?
 
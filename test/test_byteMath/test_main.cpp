@@ -0,0 +1,168 @@
+// Exhaustive checks of the inline saturating byte math in byteMath.h, against the original branchy versions
+// run with `pio test -e native`
+#include <unity.h>
+// declare the float versions too, only for the unevaluated overload checks below (the firmware builds without them)
+#define BYTEMATH_FLOAT_FUNCTIONS
+#include "byteMath.h"
+
+// every one of these calls must resolve to exactly one overload (these fail to compile if ambiguous)
+static_assert(sizeof(lerpByte(0.5)) == 1, "lerpByte(double) is ambiguous");
+static_assert(sizeof(lerpByte(0.5f)) == 1, "lerpByte(float) is ambiguous");
+static_assert(sizeof(lerpByte(1)) == 1, "lerpByte(int) is ambiguous");
+static_assert(sizeof(curvedLerpByte(0.5)) == 1, "curvedLerpByte(double) is ambiguous");
+static_assert(sizeof(curvedLerpByte(0.5f)) == 1, "curvedLerpByte(float) is ambiguous");
+static_assert(sizeof(curvedLerpByte((byte)128)) == 1, "curvedLerpByte(byte) is ambiguous");
+static_assert(sizeof(curvedLerpByte((int16_t)0)) == 1, "curvedLerpByte(int16_t) is ambiguous");
+static_assert(sizeof(curvedLerpByte((uint16_t)0)) == 1, "curvedLerpByte(uint16_t) is ambiguous");
+static_assert(curvedLerpByteQ16(byteToQ16(128)) == curvedLerpByte((byte)128), "Q0.16 and byte curves disagree");
+static_assert(curvedLerpByteQ16(40000) == curvedLerpByte((uint16_t)40000), "curvedLerpByte(uint16_t) doesn't forward to curvedLerpByteQ16");
+
+void setUp() {}
+void tearDown() {}
+
+// ---- [ REFERENCE ] ----
+// the original (pre-inline) implementations, kept verbatim apart from names
+
+static byte refSubtractByte(byte value, byte subtract, byte minValue)
+{
+    if (value <= minValue)
+    {
+        return minValue; // value is below min, no sub needed, return min
+    }
+    if (subtract >= value)
+    {
+        return minValue; // sub is greater than value, no sub needed, return min
+    }
+    return max(minValue, value - subtract); // return the greater of minValue or value minus sub
+}
+static byte refAddByte(byte value, byte add, byte maxValue)
+{
+    if (value >= maxValue)
+    {
+        return maxValue; // value is at/above max, no ad needed, return max
+    }
+    if (add >= maxValue - value)
+    {
+        return maxValue; // add exceeds max minus value, no ad needed, return max
+    }
+    return value + add; // perform addition, will not exceed max value
+}
+// positive branch of the original `addByte(byte, int, byte)`. Its negative branch used `maxValue` as a floor,
+// contrary to its docs, so negative `add` is checked against plain wide math instead (see `refClamp`)
+static byte refAddBytePositive(byte value, int add, byte maxValue)
+{
+    if (add == 0)
+    {
+        return min(value, maxValue); // no addition, assume positive, return lower of value or maxValue
+    }
+    if (value >= maxValue)
+    {
+        return maxValue; // value is at/above max, no ad needed, return max
+    }
+    if (add >= maxValue - value)
+    {
+        return maxValue; // add exceeds max minus value, no ad needed, return max
+    }
+    return value + add; // perform addition, will not exceed max value
+}
+static byte refClamp(long value, byte minValue, byte maxValue)
+{
+    return value < minValue ? minValue : value > maxValue ? maxValue : value;
+}
+
+// ---- [ TESTS ] ----
+
+static const byte limits[] = {0, 1, 127, 128, 254, 255};
+
+void test_clampByte_all_int16()
+{
+    for (byte low : limits)
+    {
+        for (byte high : limits)
+        {
+            if (low > high)
+            {
+                continue;
+            }
+            for (long i = INT16_MIN; i <= INT16_MAX; i++)
+            {
+                TEST_ASSERT_EQUAL_UINT8(refClamp(i, low, high), clampByte(i, low, high));
+            }
+        }
+    }
+}
+
+void test_byte_overloads_all_pairs_all_limits()
+{
+    for (int limit = 0; limit < 256; limit++)
+    {
+        for (int a = 0; a < 256; a++)
+        {
+            for (int b = 0; b < 256; b++)
+            {
+                TEST_ASSERT_EQUAL_UINT8(refAddByte(a, b, limit), addByte((byte)a, (byte)b, (byte)limit));
+                TEST_ASSERT_EQUAL_UINT8(refSubtractByte(a, b, limit), subtractByte((byte)a, (byte)b, (byte)limit));
+            }
+        }
+    }
+}
+
+void test_int_overloads_all_byte_int16_pairs()
+{
+    for (byte limit : limits)
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            for (long i = INT16_MIN; i <= INT16_MAX; i++)
+            {
+                int delta = (int16_t)i;
+                byte added = addByte((byte)value, delta, limit);
+                TEST_ASSERT_EQUAL_UINT8(refClamp((long)value + delta, 0, limit), added);
+                if (delta >= 0)
+                {
+                    TEST_ASSERT_EQUAL_UINT8(refAddBytePositive(value, delta, limit), added);
+                }
+                TEST_ASSERT_EQUAL_UINT8(refClamp((long)value - delta, limit, UINT8_MAX), subtractByte((byte)value, delta, limit));
+            }
+        }
+    }
+}
+
+void test_divide65535_all_values()
+{
+    // every value `divide65535` is documented for (below 2^24)
+    for (uint32_t value = 0; value < (1UL << 24); value++)
+    {
+        if (divide65535(value) != value / 65535)
+        {
+            TEST_ASSERT_EQUAL_UINT16(value / 65535, divide65535(value));
+        }
+    }
+}
+
+void test_lerpByteQ16_all_byte_q16_pairs()
+{
+    // rounded `(high - low) * lerp / 65535` from `lerpByteQ16`, for every byte span and Q0.16 lerp
+    for (uint32_t span = 0; span < 256; span++)
+    {
+        for (uint32_t lerp = 0; lerp <= UINT16_MAX; lerp++)
+        {
+            byte expected = (span * lerp + 32767) / 65535;
+            if (lerpByteQ16((uint16_t)lerp, 0, span) != expected)
+            {
+                TEST_ASSERT_EQUAL_UINT8(expected, lerpByteQ16((uint16_t)lerp, 0, span));
+            }
+        }
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clampByte_all_int16);
+    RUN_TEST(test_byte_overloads_all_pairs_all_limits);
+    RUN_TEST(test_int_overloads_all_byte_int16_pairs);
+    RUN_TEST(test_divide65535_all_values);
+    RUN_TEST(test_lerpByteQ16_all_byte_q16_pairs);
+    return UNITY_END();
+}
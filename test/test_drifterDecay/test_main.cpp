@@ -0,0 +1,107 @@
+// ByteDrifter::getValues with DECAY_ENABLED, against the per-pixel getValue loop it replaces
+// run with `pio test -e native`
+//
+// The firmware builds with decay off, so this only includes byteDrifter.h (not main.h) and
+// instantiates drifters on its own configs, never the firmware's `ByteDrifter<>`
+#define DECAY_ENABLED true
+#include <unity.h>
+#include "byteDrifter.h"
+
+#define DECAY_TEST_SEEDS 64  // seeds per config
+#define DECAY_TEST_FRAMES 40 // frames per seed, enough for the decay targets to re-randomize a few times
+#define DECAY_TEST_COUNT 300 // values per frame, long enough to saturate decay both ways
+
+void setUp() {}
+void tearDown() {}
+
+// the default config, as its own type, so it can't share (inline) code with the firmware's decay-less `ByteDrifter<>`
+struct DefaultDecayConfig : ByteDrifterConfig
+{
+};
+// default ranges, with the decay divisor and dMod range overridden
+template <byte Divisor, int8_t ModMin, int8_t ModMax>
+struct DecayTestConfig : ByteDrifterConfig
+{
+    static constexpr byte dDivisor = Divisor;
+    static constexpr int8_t dModMin = ModMin;
+    static constexpr int8_t dModMax = ModMax;
+    static constexpr byte decayMin = 0;
+    static constexpr byte decayMax = UINT8_MAX;
+};
+
+// runs a seeded drifter through both paths in lockstep, for every frame and a range of counts
+template <typename Config>
+static void checkGetValuesMatchesGetValue()
+{
+    static byte expected[DECAY_TEST_COUNT];
+    static byte actual[DECAY_TEST_COUNT];
+    byte expectedState[ByteDrifter<Config>::stateSize];
+    byte actualState[ByteDrifter<Config>::stateSize];
+    for (uint16_t seed = 0; seed < DECAY_TEST_SEEDS; seed++)
+    {
+        Random16 rngA(seed * 977);
+        Random16 rngB(seed * 977);
+        ByteDrifter<Config> perPixel(rngA);
+        ByteDrifter<Config> batched(rngB);
+        for (uint16_t frame = 0; frame < DECAY_TEST_FRAMES; frame++)
+        {
+            perPixel.tick();
+            batched.tick();
+            // vary the row length, including empty, single and past saturation
+            uint16_t count = (frame * 37 + seed) % (DECAY_TEST_COUNT + 1);
+            for (uint16_t i = 0; i < count; i++)
+            {
+                expected[i] = perPixel.getValue();
+            }
+            batched.getValues(actual, count);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, count);
+            // and both leave the drifter in the same state for the next call
+            perPixel.serialize(expectedState);
+            batched.serialize(actualState);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedState, actualState, sizeof(expectedState));
+            TEST_ASSERT_EQUAL_UINT8(perPixel.getValue(false), batched.getValue(false));
+        }
+    }
+}
+
+void test_default_decay_config()
+{
+    checkGetValuesMatchesGetValue<DefaultDecayConfig>();
+}
+void test_divisor_one()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<1, -15, 25>>();
+}
+void test_divisor_odd()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<7, -15, 25>>();
+}
+void test_divisor_large()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<255, -15, 25>>();
+}
+void test_decay_only_shrinks()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<6, 1, 127>>();
+}
+void test_decay_only_grows()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<6, -128, -1>>();
+}
+void test_full_dmod_range()
+{
+    checkGetValuesMatchesGetValue<DecayTestConfig<3, -128, 127>>();
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_default_decay_config);
+    RUN_TEST(test_divisor_one);
+    RUN_TEST(test_divisor_odd);
+    RUN_TEST(test_divisor_large);
+    RUN_TEST(test_decay_only_shrinks);
+    RUN_TEST(test_decay_only_grows);
+    RUN_TEST(test_full_dmod_range);
+    return UNITY_END();
+}
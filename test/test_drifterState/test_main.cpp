@@ -0,0 +1,152 @@
+// Save/load replay of animation state: save, run N frames, load, run N frames again, and the bytes must match
+// run with `pio test -e native`
+#include <unity.h>
+#include "main.h"
+
+#define REPLAY_FRAMES 600 // frames recorded after the save, long enough for every drifter interval to re-randomize
+#define WARMUP_FRAMES 97  // frames run before the save, so it lands mid-drift
+
+#ifndef LED_STREAM_PIXELS
+extern CRGB leds[NUM_LEDS];
+#endif
+
+void setUp() {}
+void tearDown() {}
+
+static Random16 testRng;
+
+// one ByteDrifter frame, as leds.cpp renders it: tick, then iterate down the strip
+static void drifterFrame(ByteDrifter<> &drifter, byte *frame)
+{
+    drifter.tick();
+    drifter.getValues(frame, NUM_LEDS);
+}
+static void bankFrame(ByteDrifterBank<NUM_LEDS> &bank, byte *frame)
+{
+    bank.tick();
+    memcpy(frame, bank.getValues(), NUM_LEDS);
+}
+
+void test_drifter_replays_after_load()
+{
+    static byte recorded[REPLAY_FRAMES][NUM_LEDS];
+    static byte replayed[REPLAY_FRAMES][NUM_LEDS];
+    byte state[ByteDrifter<>::stateSize];
+    testRng.setSeed(1234);
+    ByteDrifter<> drifter(testRng);
+    for (int i = 0; i < WARMUP_FRAMES; i++)
+    {
+        drifterFrame(drifter, recorded[0]);
+    }
+    // save
+    uint16_t seed = testRng.getSeed();
+    drifter.serialize(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        drifterFrame(drifter, recorded[i]);
+    }
+    // load, into a fresh drifter on a reseeded rng, so nothing carries over but the saved state
+    testRng.setSeed(~seed);
+    ByteDrifter<> loaded(testRng);
+    testRng.setSeed(seed);
+    loaded.deserialize(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        drifterFrame(loaded, replayed[i]);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(recorded, replayed, sizeof(recorded));
+}
+
+void test_drifter_bank_replays_after_load()
+{
+    static byte recorded[REPLAY_FRAMES][NUM_LEDS];
+    static byte replayed[REPLAY_FRAMES][NUM_LEDS];
+    static byte state[ByteDrifterBank<NUM_LEDS>::stateSize];
+    testRng.setSeed(4321);
+    ByteDrifterBank<NUM_LEDS> bank(testRng);
+    for (int i = 0; i < WARMUP_FRAMES; i++)
+    {
+        bankFrame(bank, recorded[0]);
+    }
+    uint16_t seed = testRng.getSeed();
+    bank.serialize(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        bankFrame(bank, recorded[i]);
+    }
+    testRng.setSeed(~seed);
+    ByteDrifterBank<NUM_LEDS> loaded(testRng);
+    testRng.setSeed(seed);
+    loaded.deserialize(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        bankFrame(loaded, replayed[i]);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(recorded, replayed, sizeof(recorded));
+}
+
+void test_drifter_frames_actually_change()
+{
+    // guard against a replay that only matches because nothing moves
+    byte first[NUM_LEDS];
+    byte frame[NUM_LEDS];
+    testRng.setSeed(1234);
+    ByteDrifter<> drifter(testRng);
+    drifterFrame(drifter, first);
+    bool changed = false;
+    for (int i = 0; i < REPLAY_FRAMES && !changed; i++)
+    {
+        drifterFrame(drifter, frame);
+        changed = memcmp(first, frame, NUM_LEDS) != 0;
+    }
+    TEST_ASSERT_TRUE(changed);
+}
+
+#if defined(ENABLE_ANIMATION) && !defined(LED_STREAM_PIXELS)
+// the firmware's own save/load, through the rendered frame buffer (there's none to compare with LED_STREAM_PIXELS)
+static void firmwareFrame(byte *frame)
+{
+    animateLEDs();
+    updateLEDs();
+    memcpy(frame, leds, sizeof(leds));
+}
+
+void test_firmware_animation_replays_after_load()
+{
+    static byte recorded[REPLAY_FRAMES][sizeof(leds)];
+    static byte replayed[REPLAY_FRAMES][sizeof(leds)];
+    byte state[ANIM_STATE_BYTES];
+    seedAnimation(1234);
+    for (int i = 0; i < WARMUP_FRAMES; i++)
+    {
+        firmwareFrame(recorded[0]);
+    }
+    saveAnimationState(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        firmwareFrame(recorded[i]);
+    }
+    seedAnimation(999); // scramble, so only the loaded state can reproduce the frames
+    firmwareFrame(replayed[0]);
+    loadAnimationState(state);
+    for (int i = 0; i < REPLAY_FRAMES; i++)
+    {
+        firmwareFrame(replayed[i]);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(recorded, replayed, sizeof(recorded));
+    TEST_ASSERT_TRUE(memcmp(recorded[0], recorded[REPLAY_FRAMES - 1], sizeof(leds)) != 0);
+}
+#endif
+
+int main()
+{
+    setup();
+    UNITY_BEGIN();
+    RUN_TEST(test_drifter_replays_after_load);
+    RUN_TEST(test_drifter_bank_replays_after_load);
+    RUN_TEST(test_drifter_frames_actually_change);
+#if defined(ENABLE_ANIMATION) && !defined(LED_STREAM_PIXELS)
+    RUN_TEST(test_firmware_animation_replays_after_load);
+#endif
+    return UNITY_END();
+}
@@ -0,0 +1,215 @@
+// Encoder decoding and acceleration, driven by synthetic spin profiles on simulated scheduler ticks,
+// read back through loopInput as the LED colour it shifts
+// run with `pio test -e native`
+#include <unity.h>
+#include "main.h"
+
+extern "C" void TIM1_COMPA_vect(void);
+extern "C" void PCINT1_vect(void);
+
+// one detent of quadrature states (CLK << 1 | DAT) from rest, in each direction
+static const byte detentCW[4] = {1, 0, 2, 3};
+static const byte detentCCW[4] = {2, 0, 1, 3};
+
+static long turnedTotal = 0; // LED colour shifted by loopInput, unwrapped
+static uint16_t inputWindow = 0;
+
+static byte ledColor()
+{
+    saveLEDData();
+    return getSaveData()->color;
+}
+
+// one scheduler tick, running loopInput every LOOP_INTERVAL_INPUT ticks and adding up the colour it shifts
+// (less than half a turn of the colour wheel per cycle, so the byte difference can't be ambiguous)
+static void tick()
+{
+    TIM1_COMPA_vect();
+    if (++inputWindow < LOOP_INTERVAL_INPUT)
+    {
+        return;
+    }
+    inputWindow = 0;
+    byte before = ledColor();
+    loopInput();
+    turnedTotal += (int8_t)(ledColor() - before);
+}
+static void idle(long ms)
+{
+    for (long i = 0; i < ms; i++)
+    {
+        tick();
+    }
+}
+static void turn(const byte *detent)
+{
+    for (byte i = 0; i < 4; i++)
+    {
+        PINB = (PINB & ~0x03) | detent[i];
+        PCINT1_vect();
+    }
+}
+// turns `detents` detents, `ms` apart, returning the total accelerated delta
+static long spin(int detents, int ms, bool clockwise)
+{
+    idle(300); // settle, slower than any acceleration
+    turnedTotal = 0;
+    for (int d = 0; d < detents; d++)
+    {
+        turn(clockwise ? detentCW : detentCCW);
+        idle(ms);
+    }
+    idle(LOOP_INTERVAL_INPUT * 2);
+    return turnedTotal;
+}
+
+void setUp()
+{
+    PINB = 0xFF; // encoder at rest, switch released
+    setupEncoder();
+    readEncoderDelta();
+    inputEvent event;
+    while (popInputEvent(event))
+    {
+        // discard anything left queued
+    }
+    inputWindow = 0;
+    resetGestures();
+}
+void tearDown() {}
+
+void test_gain_table_endpoints()
+{
+    TEST_ASSERT_EQUAL_INT8(ENC_ACCEL_GAIN_MAX, accelerateEncoderDelta(1, 0));
+    TEST_ASSERT_EQUAL_INT8(ENC_ACCEL_GAIN_MAX, accelerateEncoderDelta(1, ENC_ACCEL_FAST_MS));
+    TEST_ASSERT_EQUAL_INT8(ENC_ACCEL_GAIN_MIN, accelerateEncoderDelta(1, ENC_ACCEL_SLOW_MS));
+    TEST_ASSERT_EQUAL_INT8(ENC_ACCEL_GAIN_MIN, accelerateEncoderDelta(1, UINT8_MAX));
+    TEST_ASSERT_EQUAL_INT8(-ENC_ACCEL_GAIN_MIN, accelerateEncoderDelta(-1, UINT8_MAX));
+}
+
+void test_gain_never_rises_with_interval()
+{
+    int8_t previous = accelerateEncoderDelta(1, 0);
+    for (int interval = 1; interval <= UINT8_MAX; interval++)
+    {
+        int8_t gain = accelerateEncoderDelta(1, interval);
+        TEST_ASSERT_LESS_OR_EQUAL(previous, gain);
+        previous = gain;
+    }
+}
+
+void test_accelerated_delta_saturates()
+{
+    TEST_ASSERT_EQUAL_INT8(INT8_MAX, accelerateEncoderDelta(100, 0));
+    TEST_ASSERT_EQUAL_INT8(-INT8_MAX, accelerateEncoderDelta(-100, 0));
+}
+
+void test_slow_turn_is_not_accelerated()
+{
+    TEST_ASSERT_EQUAL_INT(10 * ENC_ACCEL_GAIN_MIN, spin(10, 200, true));
+    TEST_ASSERT_EQUAL_INT(-10 * ENC_ACCEL_GAIN_MIN, spin(10, 200, false));
+}
+
+void test_fast_spin_is_fully_accelerated()
+{
+    // each detent is scaled by its own interval, so only the first one (after settling) is slow
+    TEST_ASSERT_EQUAL_INT(ENC_ACCEL_GAIN_MIN + 39 * ENC_ACCEL_GAIN_MAX, spin(40, 5, true));
+    TEST_ASSERT_EQUAL_INT(-(ENC_ACCEL_GAIN_MIN + 39 * ENC_ACCEL_GAIN_MAX), spin(40, 5, false));
+}
+
+void test_medium_spin_is_between()
+{
+    long total = spin(10, 60, true);
+    TEST_ASSERT_GREATER_THAN(10 * ENC_ACCEL_GAIN_MIN, total);
+    TEST_ASSERT_LESS_OR_EQUAL(10 * ENC_ACCEL_GAIN_MAX - 1, total);
+}
+
+void test_first_detent_after_setup_is_slow()
+{
+    turnedTotal = 0;
+    turn(detentCW);
+    idle(LOOP_INTERVAL_INPUT);
+    TEST_ASSERT_EQUAL_INT(ENC_ACCEL_GAIN_MIN, turnedTotal);
+}
+
+void test_detent_direction_is_queued()
+{
+    turn(detentCW);
+    turn(detentCCW);
+    inputEvent event;
+    TEST_ASSERT_TRUE(popInputEvent(event));
+    TEST_ASSERT_EQUAL_UINT8(INPUT_EVENT_ENCODER_UP, event.type);
+    TEST_ASSERT_TRUE(popInputEvent(event));
+    TEST_ASSERT_EQUAL_UINT8(INPUT_EVENT_ENCODER_DOWN, event.type);
+    TEST_ASSERT_FALSE(popInputEvent(event));
+}
+
+void test_full_queue_holds_detents()
+{
+    // more detents than the queue holds, before loopInput reads any: the rest are held, not lost
+#ifdef TRACK_INPUT_QUEUE_STATS
+    byte overflows = getInputEventOverflows();
+#endif
+    for (int d = 0; d < INPUT_QUEUE_SIZE + 4; d++)
+    {
+        turn(detentCCW);
+    }
+    inputEvent event;
+    int queued = 0;
+    while (popInputEvent(event))
+    {
+        TEST_ASSERT_EQUAL_UINT8(INPUT_EVENT_ENCODER_DOWN, event.type);
+        queued++;
+    }
+    TEST_ASSERT_EQUAL_INT(INPUT_QUEUE_SIZE - 1, queued);
+    TEST_ASSERT_EQUAL_INT8(-5, readEncoderDelta());
+#ifdef TRACK_INPUT_QUEUE_STATS
+    TEST_ASSERT_EQUAL_UINT8(overflows + 5, getInputEventOverflows());
+#endif
+}
+
+void test_idle_past_tick_wrap_is_slow()
+{
+    // idle times landing just past one or more 16bit tick wraps, where an unaged timestamp
+    // would look like a few ms (max gain) interval, plus a plain long idle
+    static const long idleMs[] = {65536L + 5, 65536L + 255, 2 * 65536L + 1, 70000L};
+    for (long ms : idleMs)
+    {
+        turn(detentCW);
+        idle(ms);
+        turnedTotal = 0;
+        turn(detentCW);
+        idle(LOOP_INTERVAL_INPUT);
+        TEST_ASSERT_EQUAL_INT(ENC_ACCEL_GAIN_MIN, turnedTotal);
+    }
+}
+
+void test_bounce_is_not_a_detent()
+{
+    static const byte bounce[4] = {1, 3, 1, 3};
+    turn(bounce);
+    inputEvent event;
+    TEST_ASSERT_FALSE(popInputEvent(event));
+    TEST_ASSERT_EQUAL_INT8(0, readEncoderDelta());
+}
+
+int main()
+{
+    setup();
+    UNITY_BEGIN();
+    RUN_TEST(test_gain_table_endpoints);
+    RUN_TEST(test_gain_never_rises_with_interval);
+    RUN_TEST(test_accelerated_delta_saturates);
+#ifdef POLL_ENCODER_INTERRUPTS
+    // (spins are decoded by the pin change interrupt, which only queues detents with POLL_ENCODER_INTERRUPTS)
+    RUN_TEST(test_slow_turn_is_not_accelerated);
+    RUN_TEST(test_fast_spin_is_fully_accelerated);
+    RUN_TEST(test_medium_spin_is_between);
+    RUN_TEST(test_first_detent_after_setup_is_slow);
+    RUN_TEST(test_detent_direction_is_queued);
+    RUN_TEST(test_full_queue_holds_detents);
+    RUN_TEST(test_idle_past_tick_wrap_is_slow);
+    RUN_TEST(test_bounce_is_not_a_detent);
+#endif
+    return UNITY_END();
+}
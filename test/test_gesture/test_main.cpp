@@ -0,0 +1,131 @@
+// Switch and encoder events queued within a single input cycle, fed through loopInput to the LEDs
+// run with `pio test -e native`
+#include <unity.h>
+#include "main.h"
+
+extern "C" void TIM1_COMPA_vect(void);
+extern "C" void PCINT1_vect(void);
+extern volatile bool clearBuffersAndTimers; // set by waking, see input.cpp
+
+// one detent of quadrature states (CLK << 1 | DAT) from rest, in each direction
+static const byte detentCW[4] = {1, 0, 2, 3};
+static const byte detentCCW[4] = {2, 0, 1, 3};
+
+static void tick(int ms)
+{
+    for (int i = 0; i < ms; i++)
+    {
+        TIM1_COMPA_vect();
+    }
+}
+static void press()
+{
+    PINB &= ~(1 << PORTB_BIT_ENC_SWITCH);
+    tick(ENC_SWITCH_DEBOUNCE_TICKS + 1);
+}
+static void release()
+{
+    PINB |= (1 << PORTB_BIT_ENC_SWITCH);
+    tick(ENC_SWITCH_DEBOUNCE_TICKS + 1);
+}
+static void turn(const byte *detent)
+{
+    for (byte i = 0; i < 4; i++)
+    {
+        PINB = (PINB & ~0x03) | detent[i];
+        PCINT1_vect();
+    }
+    tick(1);
+}
+
+// current LED colour and brightness, as they'd be saved
+static saveData ledData()
+{
+    saveLEDData();
+    return *getSaveData();
+}
+
+void setUp()
+{
+    PINB = 0xFF; // encoder at rest, switch released
+    tick(GESTURE_LONG_PRESS_MS); // let anything pending time out
+    loopInput();
+    resetGestures();
+}
+void tearDown() {}
+
+void test_press_turn_release_in_one_cycle_is_press_turn()
+{
+    saveData before = ledData();
+    press();
+    turn(detentCCW);
+    release();
+    loopInput();
+    TEST_ASSERT_LESS_THAN(before.brightness, ledData().brightness);
+    TEST_ASSERT_EQUAL_UINT8(before.color, ledData().color);
+}
+
+void test_turn_then_click_in_one_cycle_is_turn()
+{
+    saveData before = ledData();
+    turn(detentCW);
+    press();
+    release();
+    loopInput();
+    TEST_ASSERT_EQUAL_UINT8(before.brightness, ledData().brightness);
+    TEST_ASSERT_NOT_EQUAL(before.color, ledData().color);
+}
+
+void test_click_then_turn_in_one_cycle_is_turn()
+{
+    saveData before = ledData();
+    press();
+    release();
+    turn(detentCW);
+    loopInput();
+    TEST_ASSERT_EQUAL_UINT8(before.brightness, ledData().brightness);
+    TEST_ASSERT_NOT_EQUAL(before.color, ledData().color);
+}
+
+#if defined(ENABLE_SLEEP) && defined(ENC_LONG_PRESS_SLEEPS)
+void test_long_press_sleeps_once_released()
+{
+    press();
+    tick(GESTURE_LONG_PRESS_MS);
+    loopInput();
+    // still held, so not asleep yet (the switch's LOW level interrupt would wake it straight back up)
+    TEST_ASSERT_FALSE(clearBuffersAndTimers);
+    release();
+    loopInput();
+    // slept and woke
+    TEST_ASSERT_TRUE(clearBuffersAndTimers);
+}
+
+void test_turn_after_long_press_cancels_sleep()
+{
+    press();
+    tick(GESTURE_LONG_PRESS_MS);
+    loopInput();
+    turn(detentCCW);
+    release();
+    loopInput();
+    TEST_ASSERT_FALSE(clearBuffersAndTimers);
+}
+#endif
+
+int main()
+{
+    setup();
+    UNITY_BEGIN();
+#if defined(USE_ENCODER_SWITCH_LOGIC) && defined(ENC_PRESS_TURN_BRIGHTNESS) && defined(POLL_ENCODER_INTERRUPTS)
+    RUN_TEST(test_press_turn_release_in_one_cycle_is_press_turn);
+    RUN_TEST(test_turn_then_click_in_one_cycle_is_turn);
+    RUN_TEST(test_click_then_turn_in_one_cycle_is_turn);
+#endif
+#if defined(ENABLE_SLEEP) && defined(ENC_LONG_PRESS_SLEEPS)
+    // (only with ENABLE_SLEEP, see sleep.h, `pio test -e native_sleep`)
+    RUN_TEST(test_long_press_sleeps_once_released);
+    RUN_TEST(test_turn_after_long_press_cancels_sleep);
+#endif
+    return UNITY_END();
+}
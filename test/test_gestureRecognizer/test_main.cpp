@@ -0,0 +1,135 @@
+// Gesture recognizer transitions, fed directly, with gestures recorded rather than routed to the LEDs
+// run with `pio test -e native`
+#include <unity.h>
+
+// a private copy of the recognizer, renamed so it links alongside the firmware's (which reports to input.cpp)
+#define resetGestures recorderResetGestures
+#define feedGesture recorderFeedGesture
+#define checkGestures recorderCheckGestures
+#define handleGesture recorderHandleGesture
+#include "gesture.cpp"
+
+static byte gestures[8]; // gestures reported since `setUp`, in order
+static byte gestureCount = 0;
+
+void recorderHandleGesture(byte gesture, int)
+{
+    if (gestureCount < sizeof(gestures))
+    {
+        gestures[gestureCount] = gesture;
+    }
+    gestureCount++;
+}
+
+static uint16_t now = 1000;
+
+static void feed(byte input, uint16_t ms = 10)
+{
+    now += ms;
+    feedGesture(input, now, input == GESTURE_INPUT_TURN ? 1 : 0);
+}
+static void wait(uint16_t ms)
+{
+    now += ms;
+    checkGestures(now);
+}
+static void click()
+{
+    feed(GESTURE_INPUT_PRESS);
+    feed(GESTURE_INPUT_RELEASE);
+}
+
+static void assertGestures(const byte *expected, byte count)
+{
+    TEST_ASSERT_EQUAL_UINT8(count, gestureCount);
+    for (byte i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(expected[i], gestures[i]);
+    }
+}
+
+void setUp()
+{
+    resetGestures();
+    gestureCount = 0;
+}
+void tearDown() {}
+
+void test_click()
+{
+    click();
+    wait(GESTURE_DOUBLE_CLICK_MS);
+    static const byte expected[] = {GESTURE_CLICK};
+    assertGestures(expected, 1);
+}
+
+void test_double_click()
+{
+    click();
+    click();
+    static const byte expected[] = {GESTURE_DOUBLE_CLICK};
+    assertGestures(expected, 1);
+}
+
+void test_press_turn_cancels_long_press()
+{
+    feed(GESTURE_INPUT_PRESS);
+    feed(GESTURE_INPUT_TURN);
+    wait(GESTURE_LONG_PRESS_MS);
+    feed(GESTURE_INPUT_RELEASE);
+    static const byte expected[] = {GESTURE_PRESS_TURN};
+    assertGestures(expected, 1);
+}
+
+void test_click_then_turn()
+{
+    click();
+    feed(GESTURE_INPUT_TURN);
+    static const byte expected[] = {GESTURE_CLICK, GESTURE_TURN};
+    assertGestures(expected, 2);
+}
+
+void test_click_then_press_turn()
+{
+    click();
+    feed(GESTURE_INPUT_PRESS);
+    feed(GESTURE_INPUT_TURN);
+    feed(GESTURE_INPUT_RELEASE);
+    static const byte expected[] = {GESTURE_CLICK, GESTURE_PRESS_TURN};
+    assertGestures(expected, 2);
+}
+
+void test_click_then_long_press()
+{
+    click();
+    feed(GESTURE_INPUT_PRESS);
+    wait(GESTURE_LONG_PRESS_MS);
+    feed(GESTURE_INPUT_RELEASE);
+    static const byte expected[] = {GESTURE_CLICK, GESTURE_LONG_PRESS};
+    assertGestures(expected, 2);
+}
+
+void test_long_press_is_timed_from_the_second_press()
+{
+    click();
+    feed(GESTURE_INPUT_PRESS);
+    wait(GESTURE_LONG_PRESS_MS - 1);
+    static const byte none[] = {GESTURE_NONE};
+    assertGestures(none, 0);
+    wait(1);
+    static const byte expected[] = {GESTURE_CLICK, GESTURE_LONG_PRESS};
+    assertGestures(expected, 2);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_click);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_press_turn_cancels_long_press);
+    RUN_TEST(test_click_then_turn);
+    RUN_TEST(test_click_then_press_turn);
+    RUN_TEST(test_click_then_long_press);
+    RUN_TEST(test_long_press_is_timed_from_the_second_press);
+    return UNITY_END();
+}
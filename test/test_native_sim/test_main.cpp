@@ -0,0 +1,54 @@
+// Smoke test of the whole firmware on the host shims: runs setup() and the scheduler loop on simulated time
+// run with `pio test -e native`
+#include <unity.h>
+#include "main.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void runUntil(unsigned long ms)
+{
+    while (millis() < ms)
+    {
+        loop();
+    }
+}
+
+void test_scheduler_tracks_millis()
+{
+    unsigned long start = millis();
+    uint16_t startTicks = getSchedulerTicks();
+    runUntil(start + 5000);
+    TEST_ASSERT_INT_WITHIN(2, 5000, (uint16_t)(getSchedulerTicks() - startTicks));
+}
+
+#ifndef LED_OUTPUT_USI
+// (USI output bypasses `FastLED.show`, so the shim can't count frames)
+void test_leds_are_shown()
+{
+    unsigned long startShows = FastLED.getShowCount();
+    runUntil(millis() + 2000);
+    TEST_ASSERT_GREATER_THAN(startShows, FastLED.getShowCount());
+}
+
+void test_color_shift_shows_frame()
+{
+    runUntil(millis() + 100);
+    unsigned long startShows = FastLED.getShowCount();
+    shiftLEDColor(16);
+    runUntil(millis() + 50);
+    TEST_ASSERT_GREATER_THAN(startShows, FastLED.getShowCount());
+}
+#endif
+
+int main()
+{
+    setup();
+    UNITY_BEGIN();
+    RUN_TEST(test_scheduler_tracks_millis);
+#ifndef LED_OUTPUT_USI
+    RUN_TEST(test_leds_are_shown);
+    RUN_TEST(test_color_shift_shows_frame);
+#endif
+    return UNITY_END();
+}
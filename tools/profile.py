@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""Cycle counts for the firmware hot paths, from the profile markers in src/profile.h.
+
+Runs a profiling build ([env:profile], built with ENABLE_PROFILING) under simavr's run_avr,
+tracing every write to GPIOR0 into a VCD file, then pairs up the entry/exit markers and
+reports min/mean/max cycles per marker as JSON, eg to diff between builds:
+
+    pio run -e profile
+    python tools/profile.py --seconds 10 > profile.json
+
+The byteMath kernels (Q0.16 next to float) are timed once at startup in [env:profile_kernels],
+so a second or so of simulation covers them:
+
+    pio run -e profile_kernels
+    python tools/profile.py --elf .pio/build/profile_kernels/firmware.elf --seconds 1
+
+Or just parse a VCD recorded some other way (GPIOR0 traced as an 8 bit signal):
+
+    python tools/profile.py --vcd trace.vcd
+
+Times include any interrupts serviced inside the window, as they'd cost the same on hardware.
+
+Markers with PROFILE_IRQ_OFF set time the windows with interrupts disabled (interrupt bodies,
+atomic blocks, the scheduler's idle check), and are reported in their own "interrupts_disabled"
+section, with the longest of them as "worst_max". The markers sit just inside each window, so
+the interrupt entry/exit and ATOMIC_BLOCK overhead is not included (see src/profile.h).
+simavr doesn't expose SREG's I bit as a traceable address, so this can't be traced directly.
+
+UNVERIFIED: the simavr path (run_avr's --add-trace/--output flags, and its VCD signal naming and
+timescale) is written from run_avr's documented usage, but hasn't yet been run against a real
+[env:profile] build, so no simavr version is known to work. Only the VCD parser below is checked
+(with the sample). Once it's been run, note the simavr version here and commit its output
+alongside the sample, eg tools/samples/profile.json.
+
+tools/samples/ holds a small hand written VCD (made up numbers, not a measurement) and the JSON
+it produces, to check the parser:
+
+    python tools/profile.py --vcd tools/samples/synthetic.vcd
+"""
+
+import argparse
+import json
+import os
+import re
+import signal
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PROFILE_H = os.path.join(ROOT, "src", "profile.h")
+DEFAULT_ELF = os.path.join(ROOT, ".pio", "build", "profile", "firmware.elf")
+GPIOR0_ADDR = 0x33  # ATtiny84 GPIOR0, data space address (I/O 0x13)
+MCU = "attiny84"
+CLOCK_HZ = 8000000
+
+TIMESCALES = {"s": 1.0, "ms": 1e-3, "us": 1e-6, "ns": 1e-9, "ps": 1e-12, "fs": 1e-15}
+
+
+def read_marker_names():
+    """Returns ({id: name}, exit bit, interrupts-disabled bit) from the `#define PROFILE_[NAME] [id]` lines in profile.h."""
+    names = {}
+    exit_bit = 0x80
+    irq_off_bit = 0x40
+    with open(PROFILE_H) as f:
+        for line in f:
+            match = re.match(r"#define PROFILE_(\w+)\s+(0x[0-9A-Fa-f]+|\d+)", line)
+            if not match:
+                continue
+            name, value = match.group(1), int(match.group(2), 0)
+            if name == "EXIT":
+                exit_bit = value
+            elif name == "IRQ_OFF":
+                irq_off_bit = value
+            else:
+                names[value] = name.lower()
+    return names, exit_bit, irq_off_bit
+
+
+def run_simavr(elf, vcd, seconds, run_avr):
+    """Runs `elf` under simavr for `seconds` of wall time, tracing GPIOR0 writes into `vcd`."""
+    command = [
+        run_avr,
+        "--mcu", MCU,
+        "--freq", str(CLOCK_HZ),
+        "--output", vcd,
+        "--add-trace", "profile=trace@0x%04x/0xff" % GPIOR0_ADDR,
+        elf,
+    ]
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL)
+    time.sleep(seconds)
+    # run_avr flushes and closes the VCD file on SIGINT
+    process.send_signal(signal.SIGINT)
+    process.wait()
+
+
+def read_vcd(path, signal_name):
+    """Yields (time in seconds, value) for every change of `signal_name` in VCD file `path`."""
+    scale = 1e-9
+    code = None
+    now = 0
+    with open(path) as f:
+        tokens = f.read().split()
+    i = 0
+    while i < len(tokens):
+        token = tokens[i]
+        if token == "$timescale":
+            value = "".join(tokens[i + 1:tokens.index("$end", i)])
+            match = re.match(r"(\d+)(\w+)", value)
+            scale = int(match.group(1)) * TIMESCALES[match.group(2)]
+        elif token == "$var" and tokens[i + 4] == signal_name:
+            code = tokens[i + 3]
+        elif token.startswith("#"):
+            now = int(token[1:])
+        elif token[0] in "bB" and i + 1 < len(tokens) and tokens[i + 1] == code:
+            bits = token[1:]
+            if all(c in "01" for c in bits):
+                yield now * scale, int(bits, 2)
+            i += 1
+        i += 1
+    if code is None:
+        sys.exit("signal '%s' not found in %s" % (signal_name, path))
+
+
+def measure(changes, names, exit_bit):
+    """Pairs entry/exit markers and returns {name: [cycles, ...]}."""
+    cycles = {name: [] for name in names.values()}
+    entered = {}
+    for when, value in changes:
+        marker = value & ~exit_bit
+        if marker not in names:
+            continue
+        if value & exit_bit:
+            if marker in entered:
+                cycles[names[marker]].append(round((when - entered.pop(marker)) * CLOCK_HZ))
+        else:
+            entered[marker] = when
+    return cycles
+
+
+def summarize(cycles, ids):
+    summary = {}
+    for marker_id, name in sorted(ids.items()):
+        samples = cycles[name]
+        if not samples:
+            summary[name] = {"calls": 0}
+            continue
+        summary[name] = {
+            "calls": len(samples),
+            "min": min(samples),
+            "mean": round(sum(samples) / len(samples), 1),
+            "max": max(samples),
+        }
+    return summary
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--elf", default=DEFAULT_ELF, help="profiling build to simulate (default: [env:profile] firmware)")
+    parser.add_argument("--vcd", help="parse this VCD instead of running simavr")
+    parser.add_argument("--signal", default="profile", help="name of the GPIOR0 signal in the VCD (default: profile)")
+    parser.add_argument("--seconds", type=float, default=5.0, help="wall time to run simavr for (default: 5)")
+    parser.add_argument("--run-avr", default="run_avr", help="simavr run_avr executable")
+    args = parser.parse_args()
+
+    names, exit_bit, irq_off_bit = read_marker_names()
+    vcd = args.vcd
+    if vcd is None:
+        vcd = os.path.splitext(args.elf)[0] + ".vcd"
+        run_simavr(args.elf, vcd, args.seconds, args.run_avr)
+
+    cycles = measure(read_vcd(vcd, args.signal), names, exit_bit)
+    markers = {i: name for i, name in names.items() if not i & irq_off_bit}
+    irq_off = {i: name for i, name in names.items() if i & irq_off_bit}
+    disabled = summarize(cycles, irq_off)
+    worst = [entry["max"] for entry in disabled.values() if entry["calls"]]
+    json.dump({
+        "mcu": MCU,
+        "clock_hz": CLOCK_HZ,
+        "markers": summarize(cycles, markers),
+        "interrupts_disabled": {"worst_max": max(worst) if worst else None, "windows": disabled},
+    }, sys.stdout, indent=2)
+    print()
+
+
+if __name__ == "__main__":
+    main()